@@ -26,12 +26,8 @@ edge_event_buffer::impl::impl(unsigned int capacity)
 	: buffer(make_edge_event_buffer(capacity)),
 	  events()
 {
-	events.reserve(capacity);
-
-	for (unsigned int i = 0; i < capacity; i++) {
-		events.push_back(edge_event());
-		events.back()._m_priv.reset(new edge_event::impl_external);
-	}
+	/* The C buffer may clamp the requested capacity. */
+	events.assign(::gpiod_edge_event_buffer_get_capacity(this->buffer.get()), edge_event());
 }
 
 int edge_event_buffer::impl::read_events(const line_request_ptr& request, unsigned int max_events)
@@ -43,8 +39,13 @@ int edge_event_buffer::impl::read_events(const line_request_ptr& request, unsign
 
 	for (int i = 0; i < ret; i++) {
 		::gpiod_edge_event* event = ::gpiod_edge_event_buffer_get_event(this->buffer.get(), i);
+		edge_event& dst = this->events[i];
 
-		dynamic_cast<edge_event::impl_external&>(*this->events[i]._m_priv).event = event;
+		dst._m_type = map_edge_event_type(::gpiod_edge_event_get_event_type(event));
+		dst._m_timestamp_ns = ::gpiod_edge_event_get_timestamp_ns(event);
+		dst._m_line_offset = ::gpiod_edge_event_get_line_offset(event);
+		dst._m_global_seqno = ::gpiod_edge_event_get_global_seqno(event);
+		dst._m_line_seqno = ::gpiod_edge_event_get_line_seqno(event);
 	}
 
 	return ret;
@@ -79,6 +80,16 @@ GPIOD_CXX_API const edge_event& edge_event_buffer::get_event(unsigned int index)
 	return this->_m_priv->events.at(index);
 }
 
+GPIOD_CXX_API const edge_event& edge_event_buffer::operator[](::std::size_t index) const noexcept
+{
+	return this->_m_priv->events[index];
+}
+
+GPIOD_CXX_API const edge_event* edge_event_buffer::data() const noexcept
+{
+	return this->_m_priv->events.data();
+}
+
 GPIOD_CXX_API ::std::size_t edge_event_buffer::num_events() const
 {
 	return ::gpiod_edge_event_buffer_get_num_events(this->_m_priv->buffer.get());
@@ -91,12 +102,12 @@ GPIOD_CXX_API ::std::size_t edge_event_buffer::capacity() const noexcept
 
 GPIOD_CXX_API edge_event_buffer::const_iterator edge_event_buffer::begin() const noexcept
 {
-	return this->_m_priv->events.begin();
+	return this->_m_priv->events.data();
 }
 
 GPIOD_CXX_API edge_event_buffer::const_iterator edge_event_buffer::end() const noexcept
 {
-	return this->_m_priv->events.begin() + this->num_events();
+	return this->_m_priv->events.data() + this->num_events();
 }
 
 GPIOD_CXX_API ::std::ostream& operator<<(::std::ostream& out, const edge_event_buffer& buf)
@@ -15,7 +15,6 @@
 #include <cstddef>
 #include <iostream>
 #include <memory>
-#include <vector>
 
 namespace gpiod {
 
@@ -32,7 +31,9 @@ class line_request;
  *
  * The edge_event_buffer allows reading edge_event objects into an existing
  * buffer which improves the performance by avoiding needless memory
- * allocations.
+ * allocations. The events currently stored in the buffer are laid out
+ * contiguously and can be accessed by index, by pointer or through
+ * random-access iterators.
  */
 class edge_event_buffer final
 {
@@ -42,7 +43,7 @@ public:
 	 * @brief Constant iterator for iterating over edge events stored in
 	 *        the buffer.
 	 */
-	using const_iterator = ::std::vector<edge_event>::const_iterator;
+	using const_iterator = const edge_event*;
 
 	/**
 	 * @brief Constructor. Creates a new edge event buffer with given
@@ -77,6 +78,22 @@ public:
 	 */
 	const edge_event& get_event(unsigned int index) const;
 
+	/**
+	 * @brief Get the constant reference to the edge event at given index
+	 *        without bounds checking.
+	 * @param index Index of the event in the buffer. Must be lower than
+	 *              num_events().
+	 * @return Constant reference to the edge event.
+	 */
+	const edge_event& operator[](::std::size_t index) const noexcept;
+
+	/**
+	 * @brief Get the pointer to the first edge event currently stored in
+	 *        the buffer.
+	 * @return Pointer to a contiguous array of num_events() edge events.
+	 */
+	const edge_event* data() const noexcept;
+
 	/**
 	 * @brief Get the number of edge events currently stored in the buffer.
 	 * @return Number of edge events in the buffer.
@@ -14,7 +14,6 @@
 
 #include <cstdint>
 #include <iostream>
-#include <memory>
 
 #include "timestamp.hpp"
 
@@ -29,6 +28,10 @@ class edge_event_buffer;
 
 /**
  * @brief Immutable object containing data about a single edge event.
+ *
+ * Edge events are plain values: the event data is stored inline, so copying
+ * an event out of an edge_event_buffer neither allocates nor depends on the
+ * lifetime of the buffer. The type is trivially copyable.
  */
 class edge_event final
 {
@@ -49,35 +52,35 @@ public:
 	 * @brief Copy constructor.
 	 * @param other Object to copy.
 	 */
-	edge_event(const edge_event& other);
+	edge_event(const edge_event& other) noexcept = default;
 
 	/**
 	 * @brief Move constructor.
 	 * @param other Object to move.
 	 */
-	edge_event(edge_event&& other) noexcept;
+	edge_event(edge_event&& other) noexcept = default;
 
-	~edge_event();
+	~edge_event() = default;
 
 	/**
 	 * @brief Copy assignment operator.
 	 * @param other Object to copy.
 	 * @return Reference to self.
 	 */
-	edge_event& operator=(const edge_event& other);
+	edge_event& operator=(const edge_event& other) noexcept = default;
 
 	/**
 	 * @brief Move assignment operator.
 	 * @param other Object to move.
 	 * @return Reference to self.
 	 */
-	edge_event& operator=(edge_event&& other) noexcept;
+	edge_event& operator=(edge_event&& other) noexcept = default;
 
 	/**
 	 * @brief Retrieve the event type.
 	 * @return Event type (rising or falling edge).
 	 */
-	event_type type() const;
+	event_type type() const noexcept;
 
 	/**
 	 * @brief Retrieve the event time-stamp.
@@ -109,13 +112,13 @@ public:
 
 private:
 
-	edge_event();
+	edge_event() = default;
 
-	struct impl;
-	struct impl_managed;
-	struct impl_external;
-
-	::std::shared_ptr<impl> _m_priv;
+	::std::uint64_t _m_timestamp_ns = 0;
+	unsigned long _m_global_seqno = 0;
+	unsigned long _m_line_seqno = 0;
+	unsigned int _m_line_offset = 0;
+	event_type _m_type = event_type::RISING_EDGE;
 
 	friend edge_event_buffer;
 };
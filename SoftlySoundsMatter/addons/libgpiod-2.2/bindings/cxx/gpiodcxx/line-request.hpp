@@ -25,6 +25,9 @@ class chip;
 class edge_event;
 class edge_event_buffer;
 class line_config;
+#if defined(__cpp_impl_coroutine)
+class edge_events_awaitable;
+#endif
 
 /**
  * @ingroup gpiod_cxx
@@ -208,6 +211,20 @@ public:
 	 */
 	::std::size_t read_edge_events(edge_event_buffer& buffer, ::std::size_t max_events);
 
+#if defined(__cpp_impl_coroutine)
+	/**
+	 * @brief Asynchronously wait for and read edge events.
+	 *
+	 * Must be awaited from a coroutine running on a gpiod::reactor. The
+	 * coroutine is suspended until the request's file descriptor becomes
+	 * readable, then events are read into the buffer up to its capacity.
+	 * @param buffer Edge event buffer to read events into.
+	 * @return Awaitable whose co_await result is the number of events read.
+	 * @note Only available when compiling with coroutine support.
+	 */
+	edge_events_awaitable next_events(edge_event_buffer& buffer);
+#endif
+
 private:
 
 	line_request();
@@ -0,0 +1,498 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/* SPDX-FileCopyrightText: 2026 SoftlySoundsMatter contributors */
+
+/**
+ * @file reactor.hpp
+ */
+
+#ifndef __LIBGPIOD_CXX_REACTOR_HPP__
+#define __LIBGPIOD_CXX_REACTOR_HPP__
+
+#if !defined(__LIBGPIOD_GPIOD_CXX_INSIDE__)
+#error "Only gpiod.hpp can be included directly."
+#endif
+
+/*
+ * The coroutine interface is header-only so that the library itself can keep
+ * being built as C++17. It's only available to users compiling with
+ * coroutine support (C++20).
+ */
+#if defined(__cpp_impl_coroutine)
+
+#include <algorithm>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <system_error>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "edge-event-buffer.hpp"
+#include "line-request.hpp"
+
+namespace gpiod {
+
+class reactor;
+
+/**
+ * @ingroup gpiod_cxx
+ * @{
+ */
+
+/**
+ * @brief Return type of coroutines run by the gpiod::reactor.
+ *
+ * A task doesn't start running when created. It must be handed over to
+ * reactor::spawn() which then owns the coroutine and resumes it from
+ * reactor::run(). Tasks can't be awaited from other coroutines.
+ */
+class task final
+{
+public:
+
+	/**
+	 * @brief Coroutine promise type.
+	 */
+	struct promise_type
+	{
+		/**
+		 * @brief Create the task object returned to the caller.
+		 * @return New task owning the coroutine.
+		 */
+		task get_return_object() noexcept
+		{
+			return task(::std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		/**
+		 * @brief Tasks start suspended and are resumed by the reactor.
+		 * @return Awaiter that always suspends.
+		 */
+		::std::suspend_always initial_suspend() const noexcept { return {}; }
+
+		/**
+		 * @brief Finished tasks stay suspended until the reactor destroys them.
+		 * @return Awaiter that always suspends.
+		 */
+		::std::suspend_always final_suspend() const noexcept { return {}; }
+
+		/**
+		 * @brief Tasks don't return values.
+		 */
+		void return_void() const noexcept { }
+
+		/**
+		 * @brief Store the exception so that reactor::run() can rethrow it.
+		 */
+		void unhandled_exception() noexcept
+		{
+			this->error = ::std::current_exception();
+		}
+
+		/**
+		 * @brief Exception that terminated the coroutine, if any.
+		 */
+		::std::exception_ptr error;
+	};
+
+	task(const task& other) = delete;
+
+	/**
+	 * @brief Move constructor.
+	 * @param other Object to move.
+	 */
+	task(task&& other) noexcept
+		: _m_handle(::std::exchange(other._m_handle, nullptr))
+	{
+
+	}
+
+	~task()
+	{
+		if (this->_m_handle)
+			this->_m_handle.destroy();
+	}
+
+	task& operator=(const task& other) = delete;
+
+	/**
+	 * @brief Move assignment operator.
+	 * @param other Object to move.
+	 * @return Reference to self.
+	 */
+	task& operator=(task&& other) noexcept
+	{
+		if (this != &other) {
+			if (this->_m_handle)
+				this->_m_handle.destroy();
+
+			this->_m_handle = ::std::exchange(other._m_handle, nullptr);
+		}
+
+		return *this;
+	}
+
+private:
+
+	explicit task(::std::coroutine_handle<promise_type> handle) noexcept
+		: _m_handle(handle)
+	{
+
+	}
+
+	::std::coroutine_handle<promise_type> _m_handle;
+
+	friend reactor;
+};
+
+/**
+ * @brief Minimal single-threaded executor driving coroutines with epoll.
+ *
+ * A reactor owns the tasks spawned on it and resumes them from run() on the
+ * calling thread. Coroutines suspend on file descriptors (line requests,
+ * chips or any other pollable descriptor) and a single epoll_wait() call
+ * wakes up whichever of them became readable, so any number of requests on
+ * any number of chips can be serviced from one thread.
+ *
+ * The reactor isn't thread-safe: spawn() and stop() must be called from the
+ * thread running (or about to run) the reactor.
+ */
+class reactor final
+{
+public:
+
+	/**
+	 * @brief Awaitable suspending the coroutine until a file descriptor
+	 *        becomes readable.
+	 */
+	class readable_awaitable final
+	{
+	public:
+
+		/**
+		 * @brief Never ready immediately: readiness is checked by epoll.
+		 * @return Always false.
+		 */
+		bool await_ready() const noexcept { return false; }
+
+		/**
+		 * @brief Register the awaiting coroutine with the reactor.
+		 * @param handle Handle of the awaiting coroutine.
+		 */
+		void await_suspend(::std::coroutine_handle<> handle)
+		{
+			this->_m_reactor.add_waiter(this->_m_fd, handle);
+		}
+
+		/**
+		 * @brief Nothing to return, the descriptor is readable.
+		 */
+		void await_resume() const noexcept { }
+
+	private:
+
+		readable_awaitable(reactor& owner, int fd) noexcept
+			: _m_reactor(owner),
+			  _m_fd(fd)
+		{
+
+		}
+
+		reactor& _m_reactor;
+		int _m_fd;
+
+		friend reactor;
+	};
+
+	/**
+	 * @brief Constructor. Creates the epoll instance.
+	 */
+	reactor()
+		: _m_epfd(::epoll_create1(EPOLL_CLOEXEC)),
+		  _m_stopped(false),
+		  _m_tasks(),
+		  _m_ready(),
+		  _m_waiters()
+	{
+		if (this->_m_epfd < 0)
+			throw ::std::system_error(errno, ::std::system_category(),
+						  "unable to create the epoll instance");
+	}
+
+	reactor(const reactor& other) = delete;
+	reactor(reactor&& other) = delete;
+
+	/**
+	 * @brief Destroys all tasks that didn't finish and closes the epoll
+	 *        instance.
+	 */
+	~reactor()
+	{
+		for (auto& handle: this->_m_tasks)
+			handle.destroy();
+
+		::close(this->_m_epfd);
+	}
+
+	reactor& operator=(const reactor& other) = delete;
+	reactor& operator=(reactor&& other) = delete;
+
+	/**
+	 * @brief Get the reactor currently running on the calling thread.
+	 * @return Pointer to the reactor inside whose run() the caller is
+	 *         executing or nullptr if there's none.
+	 */
+	static reactor* current() noexcept
+	{
+		return current_slot();
+	}
+
+	/**
+	 * @brief Take ownership of a task and schedule it to start on the next
+	 *        iteration of run().
+	 * @param coro Task to run.
+	 */
+	void spawn(task coro)
+	{
+		auto handle = ::std::exchange(coro._m_handle, nullptr);
+		if (!handle)
+			throw ::std::invalid_argument("task has no coroutine");
+
+		this->_m_tasks.push_back(handle);
+		this->_m_ready.push_back(handle);
+	}
+
+	/**
+	 * @brief Get an awaitable suspending the coroutine until the file
+	 *        descriptor becomes readable.
+	 * @param fd File descriptor to wait on. At most one coroutine can wait
+	 *           on a given descriptor at a time.
+	 * @return Awaitable object.
+	 */
+	readable_awaitable readable(int fd) noexcept
+	{
+		return readable_awaitable(*this, fd);
+	}
+
+	/**
+	 * @brief Run spawned tasks until all of them finished or stop() was
+	 *        called.
+	 *
+	 * If a task exits with an exception, the task is destroyed and the
+	 * exception is rethrown from this function. The remaining tasks stay
+	 * suspended and run() can be called again to continue them.
+	 */
+	void run()
+	{
+		current_guard guard(*this);
+
+		this->_m_stopped = false;
+
+		while (!this->_m_tasks.empty() && !this->_m_stopped) {
+			while (!this->_m_ready.empty() && !this->_m_stopped) {
+				auto handle = this->_m_ready.front();
+				this->_m_ready.pop_front();
+				this->resume(handle);
+			}
+
+			if (this->_m_tasks.empty() || this->_m_stopped)
+				break;
+
+			this->wait();
+		}
+	}
+
+	/**
+	 * @brief Make run() return once the currently running task suspends.
+	 */
+	void stop() noexcept
+	{
+		this->_m_stopped = true;
+	}
+
+	/**
+	 * @brief Get the number of tasks that didn't finish yet.
+	 * @return Number of tasks owned by the reactor.
+	 */
+	::std::size_t num_tasks() const noexcept
+	{
+		return this->_m_tasks.size();
+	}
+
+private:
+
+	using handle_type = ::std::coroutine_handle<task::promise_type>;
+
+	struct current_guard
+	{
+		explicit current_guard(reactor& self) noexcept
+			: prev(::std::exchange(current_slot(), &self))
+		{
+
+		}
+
+		~current_guard()
+		{
+			current_slot() = this->prev;
+		}
+
+		reactor* prev;
+	};
+
+	static reactor*& current_slot() noexcept
+	{
+		static thread_local reactor* slot = nullptr;
+
+		return slot;
+	}
+
+	void add_waiter(int fd, ::std::coroutine_handle<> handle)
+	{
+		if (this->_m_waiters.count(fd))
+			throw ::std::logic_error("another coroutine is already waiting on this file descriptor");
+
+		/*
+		 * Descriptors stay registered between waits and are re-armed
+		 * with EPOLL_CTL_MOD. A failing MOD means the descriptor was
+		 * closed (and possibly reused) in the meantime.
+		 */
+		struct epoll_event ev = { };
+		ev.events = EPOLLIN | EPOLLONESHOT;
+		ev.data.fd = fd;
+
+		int ret = ::epoll_ctl(this->_m_epfd, EPOLL_CTL_MOD, fd, &ev);
+		if (ret < 0 && errno == ENOENT)
+			ret = ::epoll_ctl(this->_m_epfd, EPOLL_CTL_ADD, fd, &ev);
+		if (ret < 0)
+			throw ::std::system_error(errno, ::std::system_category(),
+						  "unable to register the file descriptor with epoll");
+
+		this->_m_waiters.emplace(fd, handle);
+	}
+
+	void wait()
+	{
+		struct epoll_event events[16];
+
+		if (this->_m_waiters.empty())
+			throw ::std::logic_error("all tasks are suspended but none waits for a file descriptor");
+
+		int ret;
+		do {
+			ret = ::epoll_wait(this->_m_epfd, events, 16, -1);
+		} while (ret < 0 && errno == EINTR);
+
+		if (ret < 0)
+			throw ::std::system_error(errno, ::std::system_category(),
+						  "error waiting for file descriptors");
+
+		for (int i = 0; i < ret; i++) {
+			auto it = this->_m_waiters.find(events[i].data.fd);
+			if (it == this->_m_waiters.end())
+				continue;
+
+			this->_m_ready.push_back(it->second);
+			this->_m_waiters.erase(it);
+		}
+	}
+
+	void resume(::std::coroutine_handle<> handle)
+	{
+		handle.resume();
+
+		/* Tasks can't be nested so every resumed handle is a task. */
+		auto task_handle = handle_type::from_address(handle.address());
+		if (!task_handle.done())
+			return;
+
+		auto error = task_handle.promise().error;
+
+		this->_m_tasks.erase(::std::find(this->_m_tasks.begin(),
+						 this->_m_tasks.end(), task_handle));
+		task_handle.destroy();
+
+		if (error)
+			::std::rethrow_exception(error);
+	}
+
+	int _m_epfd;
+	bool _m_stopped;
+	::std::vector<handle_type> _m_tasks;
+	::std::deque<::std::coroutine_handle<>> _m_ready;
+	::std::unordered_map<int, ::std::coroutine_handle<>> _m_waiters;
+};
+
+/**
+ * @brief Awaitable returned by line_request::next_events().
+ *
+ * Suspends the coroutine until edge events are available on the request
+ * and then reads them into the buffer. The result of the co_await
+ * expression is the number of events read.
+ */
+class edge_events_awaitable final
+{
+public:
+
+	/**
+	 * @brief Never ready immediately: readiness is checked by epoll.
+	 * @return Always false.
+	 */
+	bool await_ready() const noexcept { return false; }
+
+	/**
+	 * @brief Register the awaiting coroutine with the current reactor.
+	 * @param handle Handle of the awaiting coroutine.
+	 */
+	void await_suspend(::std::coroutine_handle<> handle)
+	{
+		reactor* owner = reactor::current();
+		if (!owner)
+			throw ::std::logic_error("next_events() awaited outside of a running reactor");
+
+		owner->readable(this->_m_request.fd()).await_suspend(handle);
+	}
+
+	/**
+	 * @brief Read the pending events.
+	 * @return Number of events read into the buffer.
+	 */
+	::std::size_t await_resume()
+	{
+		return this->_m_request.read_edge_events(this->_m_buffer);
+	}
+
+private:
+
+	edge_events_awaitable(line_request& request, edge_event_buffer& buffer) noexcept
+		: _m_request(request),
+		  _m_buffer(buffer)
+	{
+
+	}
+
+	line_request& _m_request;
+	edge_event_buffer& _m_buffer;
+
+	friend line_request;
+};
+
+inline edge_events_awaitable line_request::next_events(edge_event_buffer& buffer)
+{
+	return edge_events_awaitable(*this, buffer);
+}
+
+/**
+ * @}
+ */
+
+} /* namespace gpiod */
+
+#endif /* defined(__cpp_impl_coroutine) */
+
+#endif /* __LIBGPIOD_CXX_REACTOR_HPP__ */
@@ -30,6 +30,7 @@ cxx_enum_type get_mapped_value(c_enum_type value,
 
 void throw_from_errno(const ::std::string& what);
 ::gpiod_line_value map_output_value(line::value value);
+edge_event::event_type map_edge_event_type(int type);
 
 template<class T, void F(T*)> struct deleter
 {
@@ -47,7 +48,6 @@ using line_settings_deleter = deleter<::gpiod_line_settings, ::gpiod_line_settin
 using line_config_deleter = deleter<::gpiod_line_config, ::gpiod_line_config_free>;
 using request_config_deleter = deleter<::gpiod_request_config, ::gpiod_request_config_free>;
 using line_request_deleter = deleter<::gpiod_line_request, ::gpiod_line_request_release>;
-using edge_event_deleter = deleter<::gpiod_edge_event, ::gpiod_edge_event_free>;
 using edge_event_buffer_deleter = deleter<::gpiod_edge_event_buffer,
 					  ::gpiod_edge_event_buffer_free>;
 
@@ -59,7 +59,6 @@ using line_settings_ptr = ::std::unique_ptr<::gpiod_line_settings, line_settings
 using line_config_ptr = ::std::unique_ptr<::gpiod_line_config, line_config_deleter>;
 using request_config_ptr = ::std::unique_ptr<::gpiod_request_config, request_config_deleter>;
 using line_request_ptr = ::std::unique_ptr<::gpiod_line_request, line_request_deleter>;
-using edge_event_ptr = ::std::unique_ptr<::gpiod_edge_event, edge_event_deleter>;
 using edge_event_buffer_ptr = ::std::unique_ptr<::gpiod_edge_event_buffer,
 						edge_event_buffer_deleter>;
 
@@ -172,49 +171,6 @@ struct line_request::impl
 	::std::vector<unsigned int> offset_buf;
 };
 
-struct edge_event::impl
-{
-	impl() = default;
-	impl(const impl& other) = delete;
-	impl(impl&& other) = delete;
-	virtual ~impl() = default;
-	impl& operator=(const impl& other) = delete;
-	impl& operator=(impl&& other) = delete;
-
-	virtual ::gpiod_edge_event* get_event_ptr() const noexcept = 0;
-	virtual ::std::shared_ptr<impl> copy(const ::std::shared_ptr<impl>& self) const = 0;
-};
-
-struct edge_event::impl_managed final : public edge_event::impl
-{
-	impl_managed() = default;
-	impl_managed(const impl_managed& other) = delete;
-	impl_managed(impl_managed&& other) = delete;
-	~impl_managed() = default;
-	impl_managed& operator=(const impl_managed& other) = delete;
-	impl_managed& operator=(impl_managed&& other) = delete;
-
-	::gpiod_edge_event* get_event_ptr() const noexcept override;
-	::std::shared_ptr<impl> copy(const ::std::shared_ptr<impl>& self) const override;
-
-	edge_event_ptr event;
-};
-
-struct edge_event::impl_external final : public edge_event::impl
-{
-	impl_external();
-	impl_external(const impl_external& other) = delete;
-	impl_external(impl_external&& other) = delete;
-	~impl_external() = default;
-	impl_external& operator=(const impl_external& other) = delete;
-	impl_external& operator=(impl_external&& other) = delete;
-
-	::gpiod_edge_event* get_event_ptr() const noexcept override;
-	::std::shared_ptr<impl> copy(const ::std::shared_ptr<impl>& self) const override;
-
-	::gpiod_edge_event *event;
-};
-
 struct edge_event_buffer::impl
 {
 	impl(unsigned int capacity);
@@ -4,9 +4,12 @@
 #include <catch2/catch_all.hpp>
 #include <chrono>
 #include <gpiod.hpp>
+#include <iterator>
 #include <sstream>
 #include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "gpiosim.hpp"
 #include "helpers.hpp"
@@ -272,6 +275,75 @@ TEST_CASE("reading multiple events", "[edge-event]")
 	}
 }
 
+TEST_CASE("edge_event_buffer is a contiguous range of events", "[edge-event]")
+{
+	auto sim = make_sim()
+		.set_num_lines(8)
+		.build();
+
+	::gpiod::chip chip(sim.dev_path());
+	::gpiod::edge_event_buffer buffer;
+
+	auto request = chip
+		.prepare_request()
+		.add_line_settings(
+			3,
+			::gpiod::line_settings()
+				.set_edge_detection(edge::BOTH)
+		)
+		.do_request();
+
+	sim.set_pull(3, pull::PULL_UP);
+	::std::this_thread::sleep_for(::std::chrono::milliseconds(10));
+	sim.set_pull(3, pull::PULL_DOWN);
+	::std::this_thread::sleep_for(::std::chrono::milliseconds(10));
+	sim.set_pull(3, pull::PULL_UP);
+	::std::this_thread::sleep_for(::std::chrono::milliseconds(10));
+
+	REQUIRE(request.wait_edge_events(::std::chrono::seconds(1)));
+	REQUIRE(request.read_edge_events(buffer) == 3);
+
+	SECTION("iterators are random-access")
+	{
+		using iterator_category = ::std::iterator_traits<
+			::gpiod::edge_event_buffer::const_iterator>::iterator_category;
+
+		REQUIRE(::std::is_same<iterator_category,
+				       ::std::random_access_iterator_tag>::value);
+		REQUIRE(buffer.end() - buffer.begin() == 3);
+		REQUIRE(buffer.begin()[2].type() == event_type::RISING_EDGE);
+		REQUIRE((buffer.end() - 2)->type() == event_type::FALLING_EDGE);
+	}
+
+	SECTION("index operator and data() view the same events")
+	{
+		REQUIRE(buffer.data() == buffer.begin());
+		REQUIRE(&buffer[0] == &buffer.get_event(0));
+
+		for (unsigned int i = 0; i < buffer.num_events(); i++) {
+			REQUIRE(buffer[i].line_offset() == 3);
+			REQUIRE(buffer[i].global_seqno() == i + 1);
+			REQUIRE(buffer.data()[i].line_seqno() == i + 1);
+		}
+	}
+
+	SECTION("copied events are independent of the buffer")
+	{
+		::std::vector<::gpiod::edge_event> events(buffer.begin(), buffer.end());
+
+		sim.set_pull(3, pull::PULL_DOWN);
+		::std::this_thread::sleep_for(::std::chrono::milliseconds(10));
+		REQUIRE(request.wait_edge_events(::std::chrono::seconds(1)));
+		REQUIRE(request.read_edge_events(buffer) == 1);
+		REQUIRE(buffer[0].global_seqno() == 4);
+
+		REQUIRE(events.size() == 3);
+		REQUIRE(events[0].global_seqno() == 1);
+		REQUIRE(events[0].type() == event_type::RISING_EDGE);
+		REQUIRE(events[2].global_seqno() == 3);
+	}
+}
+
 TEST_CASE("edge_event_buffer can be moved", "[edge-event]")
 {
 	auto sim = make_sim()
@@ -320,6 +392,12 @@ TEST_CASE("edge_event_buffer can be moved", "[edge-event]")
 	}
 }
 
+TEST_CASE("edge_event is a trivially copyable value type", "[edge-event]")
+{
+	REQUIRE(::std::is_trivially_copyable<::gpiod::edge_event>::value);
+	REQUIRE(::std::is_nothrow_copy_constructible<::gpiod::edge_event>::value);
+}
+
 TEST_CASE("edge_event can be copied and moved", "[edge-event]")
 {
 	auto sim = make_sim().build();
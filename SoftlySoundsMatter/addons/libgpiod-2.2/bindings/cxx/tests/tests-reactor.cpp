@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// SPDX-FileCopyrightText: 2026 SoftlySoundsMatter contributors
+
+#include <catch2/catch_all.hpp>
+#include <gpiod.hpp>
+
+/* The reactor is only available when building with coroutine support. */
+#if defined(__cpp_impl_coroutine)
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gpiosim.hpp"
+
+using ::gpiosim::make_sim;
+using edge = ::gpiod::line::edge;
+using pull = ::gpiosim::chip::pull;
+using event_type = ::gpiod::edge_event::event_type;
+
+namespace {
+
+class pipe_fds
+{
+public:
+	pipe_fds()
+	{
+		if (::pipe(this->fds))
+			throw ::std::runtime_error("unable to create a pipe");
+	}
+
+	~pipe_fds()
+	{
+		::close(this->fds[0]);
+		::close(this->fds[1]);
+	}
+
+	void put(char c)
+	{
+		REQUIRE(::write(this->fds[1], &c, 1) == 1);
+	}
+
+	char get()
+	{
+		char c = 0;
+
+		REQUIRE(::read(this->fds[0], &c, 1) == 1);
+
+		return c;
+	}
+
+	int rd() const noexcept
+	{
+		return this->fds[0];
+	}
+
+private:
+	int fds[2];
+};
+
+::gpiod::task count_to(int& counter, int limit)
+{
+	while (counter < limit)
+		counter++;
+
+	co_return;
+}
+
+::gpiod::task read_chars(::gpiod::reactor& reactor, pipe_fds& pipe,
+			 ::std::vector<char>& out, unsigned int num)
+{
+	while (out.size() < num) {
+		co_await reactor.readable(pipe.rd());
+		out.push_back(pipe.get());
+	}
+}
+
+::gpiod::task write_char(::gpiod::reactor& reactor, pipe_fds& in,
+			 pipe_fds& out, char c)
+{
+	co_await reactor.readable(in.rd());
+	in.get();
+	out.put(c);
+}
+
+::gpiod::task throw_error()
+{
+	throw ::std::runtime_error("task failed");
+
+	co_return;
+}
+
+::gpiod::task stop_reactor(::gpiod::reactor& reactor, bool& resumed)
+{
+	reactor.stop();
+	co_await ::std::suspend_always();
+	resumed = true;
+}
+
+TEST_CASE("reactor runs spawned tasks to completion", "[reactor]")
+{
+	::gpiod::reactor reactor;
+	int counter = 0;
+
+	reactor.spawn(count_to(counter, 5));
+	REQUIRE(counter == 0);
+	REQUIRE(reactor.num_tasks() == 1);
+
+	reactor.run();
+	REQUIRE(counter == 5);
+	REQUIRE(reactor.num_tasks() == 0);
+}
+
+TEST_CASE("reactor resumes tasks waiting on readable file descriptors", "[reactor]")
+{
+	::gpiod::reactor reactor;
+	pipe_fds first, second, trigger;
+	::std::vector<char> from_first, from_second;
+
+	SECTION("data already pending")
+	{
+		first.put('a');
+		first.put('b');
+
+		reactor.spawn(read_chars(reactor, first, from_first, 2));
+		reactor.run();
+
+		REQUIRE(from_first == ::std::vector<char>({ 'a', 'b' }));
+	}
+
+	SECTION("multiple tasks on one thread")
+	{
+		reactor.spawn(read_chars(reactor, first, from_first, 1));
+		reactor.spawn(read_chars(reactor, second, from_second, 1));
+		reactor.spawn(write_char(reactor, trigger, first, 'x'));
+
+		/* The writer task feeds the first reader once it's triggered. */
+		second.put('y');
+		trigger.put('!');
+		reactor.run();
+
+		REQUIRE(from_first == ::std::vector<char>({ 'x' }));
+		REQUIRE(from_second == ::std::vector<char>({ 'y' }));
+		REQUIRE(reactor.num_tasks() == 0);
+	}
+}
+
+TEST_CASE("reactor propagates exceptions and can be stopped", "[reactor]")
+{
+	::gpiod::reactor reactor;
+
+	SECTION("exceptions are rethrown from run()")
+	{
+		int counter = 0;
+
+		reactor.spawn(throw_error());
+		reactor.spawn(count_to(counter, 3));
+
+		REQUIRE_THROWS_AS(reactor.run(), ::std::runtime_error);
+		REQUIRE(reactor.num_tasks() == 1);
+
+		reactor.run();
+		REQUIRE(counter == 3);
+	}
+
+	SECTION("stop() returns from run() with tasks suspended")
+	{
+		bool resumed = false;
+
+		reactor.spawn(stop_reactor(reactor, resumed));
+		reactor.run();
+
+		REQUIRE_FALSE(resumed);
+		REQUIRE(reactor.num_tasks() == 1);
+	}
+
+	SECTION("current() is only set while running")
+	{
+		REQUIRE(::gpiod::reactor::current() == nullptr);
+	}
+}
+
+::gpiod::task collect_events(::gpiod::line_request& request, ::gpiod::edge_event_buffer& buffer,
+			     ::std::vector<::gpiod::edge_event>& out, unsigned int num)
+{
+	while (out.size() < num) {
+		auto count = co_await request.next_events(buffer);
+
+		for (unsigned int i = 0; i < count; i++)
+			out.push_back(buffer[i]);
+	}
+}
+
+void trigger_edges(::gpiosim::chip& sim, unsigned int offset)
+{
+	::std::this_thread::sleep_for(::std::chrono::milliseconds(30));
+	sim.set_pull(offset, pull::PULL_UP);
+	::std::this_thread::sleep_for(::std::chrono::milliseconds(30));
+	sim.set_pull(offset, pull::PULL_DOWN);
+}
+
+TEST_CASE("edge events can be awaited", "[reactor][edge-event]")
+{
+	auto sim0 = make_sim().set_num_lines(4).build();
+	auto sim1 = make_sim().set_num_lines(4).build();
+
+	auto settings = ::gpiod::line_settings().set_edge_detection(edge::BOTH);
+	auto request0 = ::gpiod::chip(sim0.dev_path())
+		.prepare_request()
+		.add_line_settings(1, settings)
+		.do_request();
+	auto request1 = ::gpiod::chip(sim1.dev_path())
+		.prepare_request()
+		.add_line_settings(2, settings)
+		.do_request();
+
+	::gpiod::edge_event_buffer buffer0, buffer1;
+	::std::vector<::gpiod::edge_event> events0, events1;
+	::gpiod::reactor reactor;
+
+	reactor.spawn(collect_events(request0, buffer0, events0, 2));
+	reactor.spawn(collect_events(request1, buffer1, events1, 2));
+
+	::std::thread thread0(trigger_edges, ::std::ref(sim0), 1);
+	::std::thread thread1(trigger_edges, ::std::ref(sim1), 2);
+
+	reactor.run();
+
+	thread0.join();
+	thread1.join();
+
+	REQUIRE(events0.size() == 2);
+	REQUIRE(events0[0].type() == event_type::RISING_EDGE);
+	REQUIRE(events0[0].line_offset() == 1);
+	REQUIRE(events0[1].type() == event_type::FALLING_EDGE);
+	REQUIRE(events1.size() == 2);
+	REQUIRE(events1[0].line_offset() == 2);
+	REQUIRE(events1[1].type() == event_type::FALLING_EDGE);
+}
+
+TEST_CASE("awaiting edge events requires a running reactor", "[reactor]")
+{
+	auto sim = make_sim().build();
+	auto request = ::gpiod::chip(sim.dev_path())
+		.prepare_request()
+		.add_line_settings(0, ::gpiod::line_settings().set_edge_detection(edge::BOTH))
+		.do_request();
+	::gpiod::edge_event_buffer buffer;
+
+	REQUIRE_THROWS_AS(request.next_events(buffer).await_suspend(::std::noop_coroutine()),
+			  ::std::logic_error);
+}
+
+} /* namespace */
+
+#endif /* defined(__cpp_impl_coroutine) */
@@ -22,6 +22,7 @@ void AudioEngine::setup(float sampleRate, int bufferSize, std::function<void(ofS
 	ofSoundStreamSettings settings;
 	settings.setOutListener(this);
 	settings.sampleRate = this->sampleRate;
+	numOutputChannels = std::min(kDefaultOutputChannels, maxOutputChannels);
 	settings.numOutputChannels = numOutputChannels;
 	settings.numInputChannels = 0;
 	settings.bufferSize = this->bufferSize;
@@ -32,6 +33,15 @@ void AudioEngine::setup(float sampleRate, int bufferSize, std::function<void(ofS
 
 void AudioEngine::close() {
 	stream.close();
+	recorder.stop();
+}
+
+bool AudioEngine::startRecording(const std::string & path) {
+	return recorder.start(path, sampleRate, numOutputChannels);
+}
+
+void AudioEngine::stopRecording() {
+	recorder.stop();
 }
 
 void AudioEngine::setRenderFn(std::function<void(ofSoundBuffer &)> fn) {
@@ -70,11 +80,17 @@ bool AudioEngine::setOutputDeviceById(int deviceId) {
 	return false;
 }
 
+int AudioEngine::negotiateOutputChannels(const ofSoundDevice & device) const {
+	if (device.outputChannels == 0) return std::min(kDefaultOutputChannels, maxOutputChannels);
+	return std::min((int)device.outputChannels, maxOutputChannels);
+}
+
 void AudioEngine::setupStreamForDevice(const ofSoundDevice & device) {
 	ofSoundStreamSettings settings;
 	settings.setOutDevice(device);
 	settings.setOutListener(this);
 	settings.sampleRate = sampleRate;
+	numOutputChannels = negotiateOutputChannels(device);
 	settings.numOutputChannels = numOutputChannels;
 	settings.numInputChannels = 0;
 	settings.bufferSize = bufferSize;
@@ -87,6 +103,7 @@ void AudioEngine::setupStreamForDevice(const ofSoundDevice & device) {
 		ofSoundStreamSettings fallback;
 		fallback.setOutListener(this);
 		fallback.sampleRate = sampleRate;
+		numOutputChannels = std::min(kDefaultOutputChannels, maxOutputChannels);
 		fallback.numOutputChannels = numOutputChannels;
 		fallback.numInputChannels = 0;
 		fallback.bufferSize = bufferSize;
@@ -97,7 +114,8 @@ void AudioEngine::setupStreamForDevice(const ofSoundDevice & device) {
 	}
 	outDeviceId = device.deviceID;
 	outDeviceApi = device.api;
-	ofLogNotice("AudioEngine") << "Using output device: " << device.name << " (id=" << outDeviceId << ")";
+	ofLogNotice("AudioEngine") << "Using output device: " << device.name << " (id=" << outDeviceId
+	                           << ", channels=" << numOutputChannels << ")";
 }
 
 bool AudioEngine::setupStreamForApiWithFallback(ofSoundDevice::Api api) {
@@ -113,9 +131,10 @@ bool AudioEngine::setupStreamForApiWithFallback(ofSoundDevice::Api api) {
 void AudioEngine::audioOut(ofSoundBuffer & buffer) {
 	if (render) {
 		render(buffer);
-		return;
+	} else {
+		fillSilence(buffer);
 	}
-	fillSilence(buffer);
+	recorder.push(buffer);
 }
 
 void AudioEngine::fillSilence(ofSoundBuffer & buffer) {
@@ -2,6 +2,9 @@
 
 #include "ofMain.h"
 
+#include "AudioRecorder.h"
+
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <string>
@@ -30,7 +33,23 @@ public:
 	/// Switch output to a specific device id (must exist in `getOutputDevices()`).
 	bool setOutputDeviceById(int deviceId);
 
-	/// Audio callback invoked by the sound stream. Calls the user render function or outputs silence.
+	/// Upper bound for the negotiated output channel count (call before `setup()` / device switches).
+	void setMaxOutputChannels(int channels) { maxOutputChannels = std::max(1, channels); }
+	/// Output channels of the running stream (negotiated from the device's `outputChannels`).
+	int getNumOutputChannels() const { return numOutputChannels; }
+
+	// Recording of the rendered output (see AudioRecorder).
+	/// Start recording the output stream to a WAV file at `path`.
+	bool startRecording(const std::string & path);
+	/// Stop recording and finalize the file (safe to call when not recording).
+	void stopRecording();
+	/// True while the output is being recorded.
+	bool isRecording() const { return recorder.isRecording(); }
+	/// Recorder state and overflow accounting.
+	const AudioRecorder & getRecorder() const { return recorder; }
+
+	/// Audio callback invoked by the sound stream. Calls the user render function or outputs silence,
+	/// then queues the buffer for the recorder when recording.
 	void audioOut(ofSoundBuffer & buffer) override;
 
 private:
@@ -41,11 +60,19 @@ private:
 
 	ofSoundStream stream;
 	std::function<void(ofSoundBuffer &)> render;
+	AudioRecorder recorder;
 	int outDeviceId = -1;
 	ofSoundDevice::Api outDeviceApi = ofSoundDevice::Api::DEFAULT;
 	int sampleRate = 44100;
 	int bufferSize = 512;
-	int numOutputChannels = 2;
+	int numOutputChannels = kDefaultOutputChannels;
+	int maxOutputChannels = 8;
+
+	// Used when the backend does not report a channel count (UNSPECIFIED fallback).
+	static constexpr int kDefaultOutputChannels = 2;
+
+	/// Pick the stream channel count for a device: all of its outputs, capped at `maxOutputChannels`.
+	int negotiateOutputChannels(const ofSoundDevice & device) const;
 
 	/// Utility: fill the output buffer with zeros.
 	static void fillSilence(ofSoundBuffer & buffer);
@@ -0,0 +1,137 @@
+#include "AudioRecorder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace {
+// RIFF sizes are 32-bit; stop appending before the data chunk would overflow.
+constexpr uint64_t kMaxDataBytes = 0xFFFFFFFFull - 36;
+
+void putLE16(unsigned char * p, uint16_t v) {
+	p[0] = (unsigned char)(v & 0xff);
+	p[1] = (unsigned char)(v >> 8);
+}
+
+void putLE32(unsigned char * p, uint32_t v) {
+	for (int i = 0; i < 4; i++) p[i] = (unsigned char)((v >> (8 * i)) & 0xff);
+}
+}
+
+AudioRecorder::~AudioRecorder() {
+	stop();
+}
+
+bool AudioRecorder::start(const std::string & filePath, int sr, int channels) {
+	if (recording.load() || writer.joinable()) return false;
+
+	file = std::fopen(filePath.c_str(), "wb");
+	if (!file) {
+		ofLogError("AudioRecorder") << "Can't create " << filePath << ": " << std::strerror(errno);
+		return false;
+	}
+	path = filePath;
+	sampleRate = sr;
+	numChannels = std::max(1, channels);
+	writeHeader(0);
+
+	ring.reset((size_t)(kRingSeconds * sampleRate) * numChannels);
+	writeBlock.assign(kWriteBlockSamples, 0.0f);
+	framesWritten = 0;
+	framesDropped = 0;
+
+	writerRunning = true;
+	writer = std::thread(&AudioRecorder::writerLoop, this);
+	recording = true;
+	ofLogNotice("AudioRecorder") << "Recording to " << path << " (" << numChannels << " ch, " << sampleRate << " Hz)";
+	return true;
+}
+
+void AudioRecorder::stop() {
+	if (!writer.joinable()) return;
+
+	// Stop the producer first and wait for an in-flight push, then let the writer flush the rest.
+	recording = false;
+	while (pushing.load()) std::this_thread::yield();
+	writerRunning = false;
+	writer.join();
+
+	const uint64_t dataBytes = framesWritten.load() * numChannels * sizeof(float);
+	writeHeader((uint32_t)std::min<uint64_t>(dataBytes, kMaxDataBytes));
+	std::fclose(file);
+	file = nullptr;
+	ofLogNotice("AudioRecorder") << "Stopped recording " << path << ": " << framesWritten.load() << " frames written, "
+	                             << framesDropped.load() << " dropped";
+}
+
+void AudioRecorder::push(const ofSoundBuffer & buffer) {
+	pushing.store(true);
+	if (!recording.load()) {
+		pushing.store(false);
+		return;
+	}
+	const size_t frames = buffer.getNumFrames();
+	if ((int)buffer.getNumChannels() != numChannels || !ring.push(buffer.getBuffer().data(), frames * numChannels)) {
+		framesDropped.fetch_add(frames, std::memory_order_relaxed);
+	}
+	pushing.store(false);
+}
+
+void AudioRecorder::writerLoop() {
+	while (writerRunning.load()) {
+		if (drain() == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(kWriterIdleMs));
+		}
+	}
+	// Final flush after the producer stopped.
+	while (drain() > 0) {
+	}
+	std::fflush(file);
+}
+
+size_t AudioRecorder::drain() {
+	size_t total = 0;
+	for (;;) {
+		// Only pop whole frames so the file never ends mid-frame.
+		const size_t maxSamples = writeBlock.size() - writeBlock.size() % (size_t)numChannels;
+		const size_t n = ring.pop(writeBlock.data(), maxSamples);
+		if (n == 0) break;
+		const size_t frames = n / numChannels;
+
+		const uint64_t writtenBytes = framesWritten.load() * numChannels * sizeof(float);
+		if (writtenBytes + n * sizeof(float) > kMaxDataBytes) {
+			framesDropped.fetch_add(frames, std::memory_order_relaxed);
+		} else if (std::fwrite(writeBlock.data(), sizeof(float), n, file) == n) {
+			framesWritten.fetch_add(frames, std::memory_order_relaxed);
+		} else {
+			framesDropped.fetch_add(frames, std::memory_order_relaxed);
+		}
+		total += n;
+		if (n < maxSamples) break;
+	}
+	return total;
+}
+
+void AudioRecorder::writeHeader(uint32_t dataBytes) {
+	// Canonical 44-byte header, WAVE_FORMAT_IEEE_FLOAT.
+	unsigned char h[44];
+	std::memcpy(h, "RIFF", 4);
+	putLE32(h + 4, 36 + dataBytes);
+	std::memcpy(h + 8, "WAVE", 4);
+	std::memcpy(h + 12, "fmt ", 4);
+	putLE32(h + 16, 16);
+	putLE16(h + 20, 3); // IEEE float
+	putLE16(h + 22, (uint16_t)numChannels);
+	putLE32(h + 24, (uint32_t)sampleRate);
+	putLE32(h + 28, (uint32_t)(sampleRate * numChannels * sizeof(float)));
+	putLE16(h + 32, (uint16_t)(numChannels * sizeof(float)));
+	putLE16(h + 34, 32);
+	std::memcpy(h + 36, "data", 4);
+	putLE32(h + 40, dataBytes);
+
+	const long pos = std::ftell(file);
+	std::fseek(file, 0, SEEK_SET);
+	std::fwrite(h, 1, sizeof(h), file);
+	if (pos > (long)sizeof(h)) std::fseek(file, pos, SEEK_SET);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include "SpscRing.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Records the output stream to a WAV file (32-bit float) without touching the disk from the audio thread.
+// The audio callback copies each buffer into a lock-free ring; a writer thread drains the ring in large
+// blocks and streams it to disk. If the ring is full (slow SD card), whole buffers are dropped and counted.
+class AudioRecorder {
+public:
+	AudioRecorder() = default;
+	~AudioRecorder();
+
+	// Non-copyable (owns a file and a writer thread)
+	AudioRecorder(const AudioRecorder &) = delete;
+	AudioRecorder & operator=(const AudioRecorder &) = delete;
+
+	/// Main thread: open `path`, allocate the ring and start the writer thread.
+	/// @return false if the file could not be created or a recording is already running.
+	bool start(const std::string & path, int sampleRate, int numChannels);
+	/// Main thread: stop capturing, flush everything queued, finalize the WAV header and close the file.
+	void stop();
+
+	/// True while capturing.
+	bool isRecording() const { return recording.load(); }
+	/// Path of the current (or last) recording.
+	const std::string & getPath() const { return path; }
+	/// Frames written to disk so far.
+	uint64_t getFramesWritten() const { return framesWritten.load(); }
+	/// Frames dropped because the ring was full or the channel count changed mid-recording.
+	uint64_t getFramesDropped() const { return framesDropped.load(); }
+
+	/// Audio thread: queue one output buffer. No allocation, locking or syscalls.
+	void push(const ofSoundBuffer & buffer);
+
+private:
+	// Seconds of audio the ring can absorb while the writer is stalled.
+	static constexpr float kRingSeconds = 4.0f;
+	// Samples per fwrite() on the writer thread.
+	static constexpr size_t kWriteBlockSamples = 1 << 16;
+	// Writer poll period when the ring is empty.
+	static constexpr int kWriterIdleMs = 20;
+
+	std::string path;
+	FILE * file = nullptr;
+	int sampleRate = 44100;
+	int numChannels = 2;
+
+	SpscRing<float> ring;
+	std::atomic<bool> recording { false };
+	std::atomic<bool> pushing { false };
+	std::atomic<uint64_t> framesWritten { 0 };
+	std::atomic<uint64_t> framesDropped { 0 };
+
+	std::thread writer;
+	std::atomic<bool> writerRunning { false };
+	std::vector<float> writeBlock;
+
+	/// Writer thread entry point.
+	void writerLoop();
+	/// Drain the ring to disk. Returns the number of samples written.
+	size_t drain();
+	/// Write (or rewrite) the 44-byte WAV header for `dataBytes` of sample data.
+	void writeHeader(uint32_t dataBytes);
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Per-pixel color features at the processed resolution, stored as separate planes (structure of arrays)
+// in column-major order: the `height` values of column `x` are contiguous, so the audio thread reads one
+// playhead column as a single linear run per plane.
+struct ColorPlanes {
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> hue;        // 0..255 around the color wheel (0 = red, 85 = green, 171 = blue)
+	std::vector<uint8_t> saturation; // 0 = gray ink, 255 = fully saturated
+
+	/// True when planes are available for a `w` x `h` image.
+	bool matches(int w, int h) const { return width == w && height == h && !hue.empty(); }
+	/// Start of column `x` in the hue plane.
+	const uint8_t * hueColumn(int x) const { return hue.data() + (size_t)x * height; }
+	/// Start of column `x` in the saturation plane.
+	const uint8_t * saturationColumn(int x) const { return saturation.data() + (size_t)x * height; }
+
+	void clear() {
+		width = 0;
+		height = 0;
+		hue.clear();
+		saturation.clear();
+	}
+};
@@ -1,12 +1,15 @@
 #include "ColumnSonifier.h"
 
+#include "PitchMapping.h"
+
 #include <algorithm>
 #include <cmath>
 
-void ColumnSonifier::setup(float sr, int bs) {
+void ColumnSonifier::setup(float sr) {
 	sampleRate = sr;
-	bufferSize = bs;
-	audioBuffer.assign(bufferSize, 0.0f);
+	for (auto & bus : buses) bus.fill(0.0f);
+	busChannels = 0;
+	audioBufferReadPos = kQuantumFrames;
 }
 
 void ColumnSonifier::setParams(float v, float minF, float maxF) {
@@ -15,21 +18,48 @@ void ColumnSonifier::setParams(float v, float minF, float maxF) {
 	maxFreq = maxF;
 }
 
+void ColumnSonifier::setSpatial(SpeakerLayout l, float spread) {
+	layout = l;
+	brightnessSpread = ofClamp(spread, 0.0f, 1.0f);
+}
+
 void ColumnSonifier::renderColumnToBuffer(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, ofSoundBuffer & out) {
 	if (imgWidth <= 0 || imgHeight <= 0 || !pixels.isAllocated()) {
 		out.getBuffer().assign(out.getNumFrames() * out.getNumChannels(), 0.0f);
+		audioBufferReadPos = kQuantumFrames; // drop stale carry-over
 		return;
 	}
 
 	const int clampedX = ofClamp(columnX, 0, imgWidth - 1);
+	const size_t frames = out.getNumFrames();
+	const size_t channels = out.getNumChannels();
+	const int spatialChannels = std::min((int)channels, kMaxChannels);
 	ensurePhasesSize(imgHeight);
-	synthesizeColumn(pixels, imgWidth, imgHeight, clampedX);
-
-	// Copy mono -> stereo
-	for (size_t i = 0; i < out.getNumFrames(); i++) {
-		const float sample = (i < audioBuffer.size()) ? audioBuffer[i] : 0.0f;
-		out.getBuffer()[i * 2] = sample;
-		out.getBuffer()[i * 2 + 1] = sample;
+	ensureRowPans(imgHeight, spatialChannels);
+	// A carried-over quantum rendered for another channel count is useless.
+	if (busChannels != spatialChannels) audioBufferReadPos = kQuantumFrames;
+
+	// Drain the current quantum, synthesizing a new one whenever it runs out.
+	// Interleave speaker buses (+ diffuse bus) into the device channels.
+	const float diffuseGain = 1.0f / std::sqrt((float)std::max(1, spatialChannels));
+	const auto & diffuse = buses[kMaxChannels];
+	auto & buf = out.getBuffer();
+	size_t frame = 0;
+	while (frame < frames) {
+		if (audioBufferReadPos >= kQuantumFrames) {
+			synthesizeColumn(pixels, imgWidth, imgHeight, clampedX, spatialChannels);
+			audioBufferReadPos = 0;
+		}
+		const size_t n = std::min(frames - frame, (size_t)(kQuantumFrames - audioBufferReadPos));
+		for (size_t i = 0; i < n; i++) {
+			const size_t src = (size_t)audioBufferReadPos + i;
+			const float shared = diffuse[src] * diffuseGain;
+			float * dst = &buf[(frame + i) * channels];
+			for (int c = 0; c < spatialChannels; c++) dst[c] = buses[(size_t)c][src] + shared;
+			for (size_t c = (size_t)spatialChannels; c < channels; c++) dst[c] = 0.0f;
+		}
+		frame += n;
+		audioBufferReadPos += (int)n;
 	}
 }
 
@@ -39,17 +69,60 @@ void ColumnSonifier::ensurePhasesSize(int height) {
 	}
 }
 
-void ColumnSonifier::synthesizeColumn(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX) {
-	audioBuffer.assign(bufferSize, 0.0f);
+void ColumnSonifier::ensureRowPans(int height, int channels) {
+	if ((int)rowPans.size() == height && rowPansChannels == channels && rowPansLayout == layout) return;
+	rowPans.assign(height, RowPan {});
+	rowPansChannels = channels;
+	rowPansLayout = layout;
+	if (channels <= 1) return; // everything on speaker 0
+
+	for (int y = 0; y < height; y++) {
+		const float t = (height > 1) ? (float)y / (height - 1) : 0.0f;
+		// Line: top row on the first speaker, bottom row on the last.
+		// Ring: rows travel once around the room and wrap back to the first speaker.
+		const float pos = (layout == SpeakerLayout::Ring) ? t * channels : t * (channels - 1);
+		int a = std::min((int)pos, channels - 1);
+		const float frac = pos - a;
+		int b = (layout == SpeakerLayout::Ring) ? (a + 1) % channels : std::min(a + 1, channels - 1);
+		if (layout == SpeakerLayout::Ring) a %= channels;
+
+		RowPan & p = rowPans[(size_t)y];
+		p.a = (uint8_t)a;
+		p.b = (uint8_t)b;
+		p.gainA = std::cos(frac * HALF_PI);
+		p.gainB = std::sin(frac * HALF_PI);
+	}
+}
+
+void ColumnSonifier::synthesizeColumn(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, int channels) {
+	for (int c = 0; c < channels; c++) buses[(size_t)c].fill(0.0f);
+	buses[kMaxChannels].fill(0.0f);
+	busChannels = channels;
+
+	// Color planes are column-major: this column is one contiguous run per plane.
+	const bool useColor = colorPlanes && colorPlanes->matches(imgWidth, imgHeight);
+	const uint8_t * hueCol = useColor ? colorPlanes->hueColumn(columnX) : nullptr;
+	const uint8_t * satCol = useColor ? colorPlanes->saturationColumn(columnX) : nullptr;
+
 	int active = 0;
 	for (int y = 0; y < imgHeight; y++) {
 		const float b = getPixelBrightness(pixels, imgWidth, columnX, y);
 		if (b > brightnessThreshold) {
 			active++;
-			addFrequencyToBuffer(y, b, imgHeight);
+			float octaveRatio = 1.0f;
+			float harmonics = 0.0f;
+			if (useColor && satCol[y] >= kColorSaturationThreshold) {
+				// Hue sectors: red/yellow/magenta = base octave, green/cyan = up, blue/violet = down.
+				const int hue = hueCol[y];
+				if (hue >= 43 && hue < 128) octaveRatio = 2.0f;
+				else if (hue >= 128 && hue < 213) octaveRatio = 0.5f;
+				harmonics = (satCol[y] - kColorSaturationThreshold) / (255.0f - kColorSaturationThreshold);
+			}
+			renderVoice(y, b, imgHeight, octaveRatio, harmonics);
+			panVoice(y, b);
 		}
 	}
-	normalizeAudioBuffer(active);
+	normalizeBuses(active, channels);
 }
 
 float ColumnSonifier::getPixelBrightness(const ofPixels & pixels, int imgWidth, int x, int y) {
@@ -57,37 +130,60 @@ float ColumnSonifier::getPixelBrightness(const ofPixels & pixels, int imgWidth,
 	return pixels[idx] / 255.0f;
 }
 
-void ColumnSonifier::addFrequencyToBuffer(int y, float brightness, int totalHeight) {
-	const float freq = calculateFrequencyFromY(y, totalHeight);
+void ColumnSonifier::renderVoice(int y, float brightness, int totalHeight, float octaveRatio, float harmonics) {
+	float freq = calculateFrequencyFromY(y, totalHeight) * octaveRatio;
+	// Keep the 3rd harmonic of colored voices below Nyquist.
+	if (harmonics > 0.0f) freq = std::min(freq, sampleRate / 6.0f);
 	const float phaseInc = (freq / sampleRate) * TWO_PI;
-	for (int i = 0; i < bufferSize; i++) {
-		audioBuffer[i] += sin(phases[y]) * brightness * volume;
-		phases[y] += phaseInc;
-		if (phases[y] >= TWO_PI) phases[y] -= TWO_PI;
+	const float amp = brightness * volume;
+	float phase = phases[y];
+	if (harmonics <= 0.0f) {
+		for (int i = 0; i < kQuantumFrames; i++) {
+			voiceBuffer[(size_t)i] = sin(phase) * amp;
+			phase += phaseInc;
+			if (phase >= TWO_PI) phase -= TWO_PI;
+		}
+	} else {
+		// sin(2p) = 2 sin cos, sin(3p) = sin (3 - 4 sin^2): two trig calls per sample for three partials.
+		const float h2 = 0.5f * harmonics;
+		const float h3 = 0.33f * harmonics;
+		const float norm = amp / (1.0f + h2 + h3);
+		for (int i = 0; i < kQuantumFrames; i++) {
+			const float sn = sin(phase);
+			const float cs = cos(phase);
+			voiceBuffer[(size_t)i] = (sn + h2 * 2.0f * sn * cs + h3 * sn * (3.0f - 4.0f * sn * sn)) * norm;
+			phase += phaseInc;
+			if (phase >= TWO_PI) phase -= TWO_PI;
+		}
 	}
+	phases[y] = phase;
+}
+
+void ColumnSonifier::panVoice(int y, float brightness) {
+	const RowPan & p = rowPans[(size_t)y];
+	// Dim voices drift towards the diffuse bus (equal-power split) when brightness spread is enabled.
+	const float diffuse = brightnessSpread * (1.0f - brightness);
+	const float focus = std::sqrt(1.0f - diffuse);
+	accumulate(buses[p.a].data(), voiceBuffer.data(), p.gainA * focus);
+	if (p.gainB > 0.0f) accumulate(buses[p.b].data(), voiceBuffer.data(), p.gainB * focus);
+	if (diffuse > 0.0f) accumulate(buses[kMaxChannels].data(), voiceBuffer.data(), std::sqrt(diffuse));
+}
+
+void ColumnSonifier::accumulate(float * __restrict dst, const float * __restrict src, float gain) {
+	for (int i = 0; i < kQuantumFrames; i++) dst[i] += src[i] * gain;
 }
 
 float ColumnSonifier::calculateFrequencyFromY(int y, int totalHeight) const {
-	// Simple 6-note scale repeated across octaves.
-	const std::vector<float> scale = { 0, 3, 5, 7, 10, 12 };
-	float normalizedY = 1.0f;
-	if (totalHeight > 1) normalizedY = 1.0f - (float)y / (totalHeight - 1);
-
-	const int octaveCount = 4;
-	const int totalNotes = (int)scale.size() * octaveCount;
-	const int noteIndex = (int)(normalizedY * (totalNotes - 1));
-	const int octave = noteIndex / (int)scale.size();
-	const int scaleNote = (int)scale[noteIndex % (int)scale.size()];
-
-	const float midiNote = 48 + octave * 12 + scaleNote; // C3 base
-	const float baseFreq = 440.0f * pow(2.0f, (midiNote - 69) / 12.0f);
-	return ofMap(baseFreq, 130.8128f, 2093.0045f, minFreq, maxFreq, true);
+	return rowToFrequency(y, totalHeight, minFreq, maxFreq);
 }
 
-void ColumnSonifier::normalizeAudioBuffer(int activeFrequencies) {
+void ColumnSonifier::normalizeBuses(int activeFrequencies, int channels) {
 	if (activeFrequencies <= 0) return;
 	const float normalization = 1.0f / sqrt((float)activeFrequencies);
-	for (auto & s : audioBuffer) s *= normalization;
+	for (int c = 0; c < channels; c++) {
+		for (auto & s : buses[(size_t)c]) s *= normalization;
+	}
+	for (auto & s : buses[kMaxChannels]) s *= normalization;
 }
 
 
@@ -2,49 +2,111 @@
 
 #include "ofMain.h"
 
+#include "ColorPlanes.h"
+
+#include <array>
+#include <cstdint>
 #include <vector>
 
 // Turns a single column of an image (typically Sobel brightness) into audio.
 // Mapping:
 // - each bright pixel becomes a sine oscillator
 // - vertical position -> frequency (top high, bottom low)
+// - vertical position -> speaker position in the output layout (equal-power pairwise panning)
+// - optional color planes: hue -> octave (reds stay, greens up, blues down), saturation -> timbre
+//   (adds 2nd/3rd harmonics); gray ink is unaffected
+//
+// Synthesis runs in a fixed internal quantum (`kQuantumFrames`) independent of the device period.
+// Leftover frames of a quantum carry over to the next callback, so any buffer size works.
+//
+// Each voice is rendered once into a scratch block, then accumulated into at most two speaker buses
+// plus a shared diffuse bus, so mixing cost grows with voices + channels rather than voices x channels.
 class ColumnSonifier {
 public:
-	/// Configure the synthesis engine with audio stream parameters.
-	void setup(float sampleRate, int bufferSize);
+	/// Internal processing block size in frames.
+	static constexpr int kQuantumFrames = 64;
+	/// Maximum number of spatialized output channels (extra device channels are silent).
+	static constexpr int kMaxChannels = 8;
+
+	// How output channels are arranged physically.
+	enum class SpeakerLayout {
+		Line, // speakers left-to-right (stereo = L/R); top rows go to the first speaker
+		Ring  // speakers around the room; rows wrap from the last speaker back to the first
+	};
+
+	/// Configure the synthesis engine with the audio stream sample rate.
+	void setup(float sampleRate);
 	/// Set runtime parameters controlling volume and frequency range mapping.
 	void setParams(float volume, float minFreq, float maxFreq);
+	/// Configure spatialization.
+	/// @param brightnessSpread 0 = every voice panned to its row position; 1 = dim voices fully diffuse
+	///        (sent equally to all speakers) while bright voices stay focused.
+	void setSpatial(SpeakerLayout layout, float brightnessSpread);
+	/// Current speaker layout.
+	SpeakerLayout getSpeakerLayout() const { return layout; }
+	/// Use color planes matching the rendered image (nullptr = monochrome). Planes with other
+	/// dimensions than the image are ignored.
+	void setColorPlanes(const ColorPlanes * planes) { colorPlanes = planes; }
 
 	// Generate audio for a column of pixels (grayscale 0..255).
 	// `imgWidth`/`imgHeight` are needed to interpret pixel indexing and build phases.
-	/// Render the selected image column to `out` (stereo). Outputs silence when inputs are invalid.
+	/// Render the selected image column to `out` (any frame/channel count). Outputs silence when inputs are invalid.
 	void renderColumnToBuffer(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, ofSoundBuffer & out);
 
 private:
 	float sampleRate = 44100.0f;
-	int bufferSize = 512;
 
 	float volume = 0.5f;
 	float minFreq = 100.0f;
 	float maxFreq = 4000.0f;
 	float brightnessThreshold = 0.1f;
 
+	SpeakerLayout layout = SpeakerLayout::Line;
+	float brightnessSpread = 0.0f;
+
+	const ColorPlanes * colorPlanes = nullptr;
+	// Below this saturation a pixel counts as gray ink (no color effect).
+	static constexpr uint8_t kColorSaturationThreshold = 64;
+
+	// Per-row panning: the two speakers a row sits between and their equal-power gains.
+	struct RowPan {
+		uint8_t a = 0;
+		uint8_t b = 0;
+		float gainA = 1.0f;
+		float gainB = 0.0f;
+	};
+	std::vector<RowPan> rowPans;
+	int rowPansChannels = 0;
+	SpeakerLayout rowPansLayout = SpeakerLayout::Line;
+
 	std::vector<float> phases;
-	std::vector<float> audioBuffer;
+	std::array<float, kQuantumFrames> voiceBuffer {};
+	// One bus per speaker plus the diffuse bus (index `kMaxChannels`).
+	std::array<std::array<float, kQuantumFrames>, kMaxChannels + 1> buses {};
+	int busChannels = 0;
+	int audioBufferReadPos = kQuantumFrames; // == kQuantumFrames when the quantum is fully consumed
 
 	/// Ensure `phases` contains one phase accumulator per image row.
 	void ensurePhasesSize(int height);
-	/// Synthesize mono audio for one column into the internal `audioBuffer`.
-	void synthesizeColumn(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX);
+	/// Rebuild `rowPans` when the image height, channel count or layout changed.
+	void ensureRowPans(int height, int channels);
+	/// Synthesize one quantum of audio for one column into the speaker buses.
+	void synthesizeColumn(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, int channels);
 
 	/// Read normalized brightness (0..1) at a pixel (x,y) from a grayscale pixel buffer.
 	static float getPixelBrightness(const ofPixels & pixels, int imgWidth, int x, int y);
 	/// Map a row index to a target frequency in Hz.
 	float calculateFrequencyFromY(int y, int totalHeight) const;
-	/// Add a sine oscillator corresponding to row `y` into the buffer, scaled by brightness and volume.
-	void addFrequencyToBuffer(int y, float brightness, int totalHeight);
+	/// Render the oscillator for row `y` into `voiceBuffer`, scaled by brightness and volume.
+	/// @param octaveRatio Frequency multiplier from the hue (1 = no shift).
+	/// @param harmonics 0 = pure sine, 1 = strongest 2nd/3rd harmonic mix (from the saturation).
+	void renderVoice(int y, float brightness, int totalHeight, float octaveRatio, float harmonics);
+	/// Mix `voiceBuffer` into the speaker buses according to the row's pan and the voice brightness.
+	void panVoice(int y, float brightness);
 	/// Normalize summed audio by active oscillator count to stabilize loudness.
-	void normalizeAudioBuffer(int activeFrequencies);
+	void normalizeBuses(int activeFrequencies, int channels);
+	/// dst[i] += src[i] * gain over one quantum (contiguous, vectorizes).
+	static void accumulate(float * __restrict dst, const float * __restrict src, float gain);
 };
 
 
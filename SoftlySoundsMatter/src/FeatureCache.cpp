@@ -0,0 +1,201 @@
+#include "FeatureCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+constexpr const char * kExtension = ".ssmf";
+}
+
+FeatureCache::~FeatureCache() {
+	close();
+}
+
+void FeatureCache::setup(const std::string & dir, uint64_t budget) {
+	close();
+	std::error_code ec;
+	fs::create_directories(dir, ec);
+	if (ec) {
+		ofLogWarning("FeatureCache") << "Can't create " << dir << ": " << ec.message() << " (cache disabled)";
+		return;
+	}
+	directory = dir;
+	budgetBytes = budget;
+}
+
+void FeatureCache::close() {
+	if (storePending && isEnabled()) {
+		// Don't lose the last processed map on exit.
+		joinWriter(true);
+		writeEntry(pendingKey, std::move(pendingPixels));
+	}
+	storePending = false;
+	pendingPixels.clear();
+	joinWriter(true);
+	unmap(previous);
+	unmap(current);
+	directory.clear();
+}
+
+bool FeatureCache::lookup(uint64_t key, int width, int height, ofPixels & out) {
+	if (!isEnabled() || width <= 0 || height <= 0) return false;
+
+	const std::string path = pathForKey(key);
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return false;
+
+	const size_t expected = kDataOffset + (size_t)width * height;
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || (size_t)st.st_size != expected) {
+		::close(fd);
+		return false;
+	}
+	// Private + writable: consumers may modify the pixels without touching the file.
+	void * addr = ::mmap(nullptr, expected, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (addr == MAP_FAILED) return false;
+
+	Header h;
+	std::memcpy(&h, addr, sizeof(h));
+	if (std::memcmp(h.magic, "SSMF", 4) != 0 || h.version != kVersion || h.key != key ||
+	    (int)h.width != width || (int)h.height != height) {
+		::munmap(addr, expected);
+		return false;
+	}
+
+	// Mark as recently used for eviction.
+	::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+
+	unmap(previous);
+	previous = current;
+	current = Mapping { addr, expected };
+	out.setFromExternalPixels(static_cast<unsigned char *>(addr) + kDataOffset, width, height, OF_PIXELS_GRAY);
+	return true;
+}
+
+void FeatureCache::scheduleStore(uint64_t key, const ofPixels & pixels, uint64_t nowMs) {
+	if (!isEnabled()) return;
+	pendingKey = key;
+	pendingPixels = pixels;
+	pendingSinceMs = nowMs;
+	storePending = true;
+}
+
+void FeatureCache::update(uint64_t nowMs) {
+	joinWriter(false);
+	if (!storePending || nowMs - pendingSinceMs < kStoreDelayMs || writer.joinable()) return;
+	storePending = false;
+	writerDone = false;
+	writer = std::thread([this, key = pendingKey, pixels = std::move(pendingPixels)]() mutable {
+		writeEntry(key, std::move(pixels));
+		writerDone = true;
+	});
+	pendingPixels.clear();
+}
+
+uint64_t FeatureCache::hash(const void * data, size_t bytes, uint64_t seed) {
+	const unsigned char * p = static_cast<const unsigned char *>(data);
+	uint64_t h = seed;
+	// Word-at-a-time keeps hashing a multi-megapixel source in the low milliseconds.
+	for (; bytes >= 8; bytes -= 8, p += 8) {
+		uint64_t w;
+		std::memcpy(&w, p, 8);
+		h = (h ^ w) * kFnvPrime;
+	}
+	for (; bytes > 0; bytes--, p++) {
+		h = (h ^ *p) * kFnvPrime;
+	}
+	return h;
+}
+
+std::string FeatureCache::pathForKey(uint64_t key) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+	return (fs::path(directory) / (std::string(name) + kExtension)).string();
+}
+
+void FeatureCache::writeEntry(uint64_t key, ofPixels pixels) {
+	if (!pixels.isAllocated() || pixels.getNumChannels() != 1) return;
+
+	const std::string path = pathForKey(key);
+	const std::string tmp = path + ".tmp";
+	FILE * f = std::fopen(tmp.c_str(), "wb");
+	if (!f) {
+		ofLogWarning("FeatureCache") << "Can't write " << tmp << ": " << std::strerror(errno);
+		return;
+	}
+
+	unsigned char header[kDataOffset] = {};
+	Header h;
+	std::memcpy(h.magic, "SSMF", 4);
+	h.version = kVersion;
+	h.key = key;
+	h.width = (uint32_t)pixels.getWidth();
+	h.height = (uint32_t)pixels.getHeight();
+	std::memcpy(header, &h, sizeof(h));
+
+	const size_t bytes = (size_t)h.width * h.height;
+	const bool ok = std::fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+	                std::fwrite(pixels.getData(), 1, bytes, f) == bytes;
+	if (std::fclose(f) != 0 || !ok) {
+		std::remove(tmp.c_str());
+		return;
+	}
+	// Readers only ever see complete files.
+	std::error_code ec;
+	fs::rename(tmp, path, ec);
+	if (ec) {
+		fs::remove(tmp, ec);
+		return;
+	}
+	evict();
+}
+
+void FeatureCache::evict() {
+	struct Entry {
+		fs::path path;
+		uint64_t size;
+		fs::file_time_type lastUse;
+	};
+	std::vector<Entry> entries;
+	uint64_t total = 0;
+	std::error_code ec;
+	for (const auto & e : fs::directory_iterator(directory, ec)) {
+		if (!e.is_regular_file(ec) || e.path().extension() != kExtension) continue;
+		const uint64_t size = e.file_size(ec);
+		entries.push_back({ e.path(), size, e.last_write_time(ec) });
+		total += size;
+	}
+	if (total <= budgetBytes) return;
+
+	// Oldest first (hits refresh the timestamp in `lookup()`).
+	std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) { return a.lastUse < b.lastUse; });
+	for (const auto & e : entries) {
+		if (total <= budgetBytes) break;
+		// Unlinking a file that is still mapped is fine: the mapping keeps the data alive.
+		if (fs::remove(e.path, ec)) total -= e.size;
+	}
+}
+
+void FeatureCache::joinWriter(bool wait) {
+	if (!writer.joinable()) return;
+	if (!wait && !writerDone.load()) return;
+	writer.join();
+}
+
+void FeatureCache::unmap(Mapping & m) {
+	if (m.addr) ::munmap(m.addr, m.length);
+	m = Mapping();
+}
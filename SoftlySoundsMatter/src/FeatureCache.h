@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Persistent cache of processed feature maps (Sobel images), one file per
+// (source content hash, processing parameters) key.
+// - Hits are memory-mapped (MAP_PRIVATE) and handed to an ofPixels without copying.
+// - Stores are deferred until the parameters have settled for `kStoreDelayMs` (knob sweeps don't write
+//   a file per frame) and run on a writer thread, followed by eviction of the least recently used files
+//   beyond the size budget.
+class FeatureCache {
+public:
+	/// Default disk budget for all cached maps.
+	static constexpr uint64_t kDefaultBudgetBytes = 64ull * 1024 * 1024;
+	/// A processed map must stay current this long before it is written.
+	static constexpr uint64_t kStoreDelayMs = 1000;
+
+	FeatureCache() = default;
+	~FeatureCache();
+
+	// Non-copyable (owns a mapping and a writer thread)
+	FeatureCache(const FeatureCache &) = delete;
+	FeatureCache & operator=(const FeatureCache &) = delete;
+
+	/// Enable the cache in directory `dir` (created if missing), keeping at most `budgetBytes` on disk.
+	void setup(const std::string & dir, uint64_t budgetBytes = kDefaultBudgetBytes);
+	/// Flush a pending store, join the writer and unmap everything (safe to call multiple times).
+	void close();
+	bool isEnabled() const { return !directory.empty(); }
+
+	/// Map the entry for `key` into `out` as external pixels (width x height, OF_PIXELS_GRAY).
+	/// The mapping stays valid until the next successful `lookup()` after this one, or `close()`.
+	/// Writes to `out` stay private to the process (copy-on-write).
+	/// @return false on a miss or a size mismatch.
+	bool lookup(uint64_t key, int width, int height, ofPixels & out);
+	/// Remember `pixels` as the map for `key`; written after `kStoreDelayMs` unless superseded.
+	void scheduleStore(uint64_t key, const ofPixels & pixels, uint64_t nowMs);
+	/// Main thread: start the deferred store once it is due.
+	void update(uint64_t nowMs);
+
+	/// FNV-1a over 64-bit words (tail bytes folded individually), chainable through `seed`.
+	static uint64_t hash(const void * data, size_t bytes, uint64_t seed = kFnvOffset);
+	/// Hash of a trivially copyable value, chainable through `seed`.
+	template <typename T>
+	static uint64_t hashValue(const T & value, uint64_t seed) { return hash(&value, sizeof(T), seed); }
+
+	static constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ull;
+
+private:
+	// On-disk layout: Header, padding to kDataOffset, then width*height gray bytes.
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint64_t key;
+		uint32_t width;
+		uint32_t height;
+	};
+	static constexpr uint32_t kVersion = 1;
+	static constexpr size_t kDataOffset = 64;
+
+	// One mmap'ed file.
+	struct Mapping {
+		void * addr = nullptr;
+		size_t length = 0;
+	};
+
+	std::string directory;
+	uint64_t budgetBytes = kDefaultBudgetBytes;
+
+	// The map handed out by the last hit, and the one before it (a consumer may still be reading it).
+	Mapping current;
+	Mapping previous;
+
+	// Deferred store
+	bool storePending = false;
+	uint64_t pendingKey = 0;
+	uint64_t pendingSinceMs = 0;
+	ofPixels pendingPixels;
+
+	std::thread writer;
+	std::atomic<bool> writerDone { false };
+
+	/// Cache file path for `key`.
+	std::string pathForKey(uint64_t key) const;
+	/// Writer thread: write `pixels` atomically (temp file + rename), then evict down to the budget.
+	void writeEntry(uint64_t key, ofPixels pixels);
+	/// Remove least recently used entries until the directory fits `budgetBytes`.
+	void evict();
+	/// Join a finished (or, with `wait`, any) writer thread.
+	void joinWriter(bool wait);
+	static void unmap(Mapping & m);
+};
@@ -0,0 +1,160 @@
+#include "GranularSynth.h"
+
+#include "PitchMapping.h"
+
+#include <algorithm>
+#include <cmath>
+
+void GranularSynth::setup(float sr) {
+	sampleRate = sr;
+	activeCount = 0;
+	smoothedGain = 0.0f;
+	// Pre-size the mono scratch for typical periods; it only grows if a device asks for more.
+	mixBuffer.assign(4096, 0.0f);
+}
+
+void GranularSynth::setParams(float v, float minF, float maxF) {
+	volume = v;
+	minFreq = minF;
+	maxFreq = maxF;
+}
+
+void GranularSynth::setGrainParams(float d, float ms, int radius) {
+	density = std::max(0.0f, d);
+	grainMs = std::max(1.0f, ms);
+	columnRadius = std::max(0, radius);
+}
+
+void GranularSynth::renderColumnToBuffer(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, ofSoundBuffer & out) {
+	auto & buf = out.getBuffer();
+	if (imgWidth <= 0 || imgHeight <= 0 || !pixels.isAllocated()) {
+		std::fill(buf.begin(), buf.end(), 0.0f);
+		return;
+	}
+
+	const int frames = (int)out.getNumFrames();
+	const size_t channels = out.getNumChannels();
+	if ((int)mixBuffer.size() < frames) mixBuffer.assign((size_t)frames, 0.0f);
+	if ((int)nextSpawn.size() != imgHeight) {
+		nextSpawn.assign((size_t)imgHeight, 0.0f);
+		rowDensity.assign((size_t)imgHeight, 0.0f);
+	}
+
+	scanNeighbourhood(pixels, imgWidth, imgHeight, ofClamp(columnX, 0, imgWidth - 1));
+	scheduleGrains(imgHeight, frames);
+	std::fill(mixBuffer.begin(), mixBuffer.begin() + frames, 0.0f);
+	mixGrains(frames);
+
+	// Loudness follows ~1/sqrt(overlapping grains); smoothed per buffer to avoid pumping.
+	const float targetGain = volume / std::sqrt((float)std::max(1, activeCount));
+	const float startGain = smoothedGain;
+	smoothedGain += (targetGain - smoothedGain) * 0.2f;
+	const float gainStep = (smoothedGain - startGain) / std::max(1, frames);
+	float gain = startGain;
+	for (int i = 0; i < frames; i++) {
+		const float sample = mixBuffer[(size_t)i] * gain;
+		gain += gainStep;
+		float * dst = &buf[(size_t)i * channels];
+		for (size_t c = 0; c < channels; c++) dst[c] = sample;
+	}
+}
+
+void GranularSynth::scanNeighbourhood(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX) {
+	const int x0 = std::max(0, columnX - columnRadius);
+	const int x1 = std::min(imgWidth - 1, columnX + columnRadius);
+	for (int y = 0; y < imgHeight; y++) {
+		const unsigned char * row = &pixels[(size_t)y * imgWidth];
+		unsigned char m = 0;
+		for (int x = x0; x <= x1; x++) m = std::max(m, row[x]);
+		rowDensity[(size_t)y] = m / 255.0f;
+	}
+}
+
+void GranularSynth::scheduleGrains(int imgHeight, int frames) {
+	for (int y = 0; y < imgHeight; y++) {
+		const float b = rowDensity[(size_t)y];
+		float & t = nextSpawn[(size_t)y];
+		if (b <= brightnessThreshold || density <= 0.0f) {
+			// Dark row: restart with a random offset so rows don't fire in lockstep when lit again.
+			t = random01() * sampleRate / std::max(1.0f, density);
+			continue;
+		}
+		const float interval = sampleRate / (density * b);
+		while (t < (float)frames) {
+			spawnGrain(y, imgHeight, b, (int)t);
+			// +/-50% jitter keeps the texture from sounding periodic.
+			t += interval * (0.5f + random01());
+		}
+		t -= (float)frames;
+	}
+}
+
+void GranularSynth::spawnGrain(int row, int imgHeight, float brightness, int delay) {
+	if (activeCount >= kMaxGrains) return;
+	const int g = activeCount++;
+	const float freq = rowToFrequency(row, imgHeight, minFreq, maxFreq);
+	const float length = std::max(16.0f, grainMs * 0.001f * sampleRate);
+	grainPhase[(size_t)g] = random01();
+	grainPhaseInc[(size_t)g] = freq / sampleRate;
+	grainPos[(size_t)g] = 0.0f;
+	grainLength[(size_t)g] = length;
+	grainInvLen[(size_t)g] = 1.0f / length;
+	grainAmp[(size_t)g] = brightness;
+	grainDelay[(size_t)g] = delay;
+}
+
+void GranularSynth::mixGrains(int frames) {
+	float * dst = mixBuffer.data();
+	int g = 0;
+	while (g < activeCount) {
+		const size_t i = (size_t)g;
+		const int start = std::min(grainDelay[i], frames);
+		const int remaining = (int)std::ceil(grainLength[i] - grainPos[i]);
+		const int n = std::min(frames - start, remaining);
+		if (n > 0) {
+			mixGrain(dst + start, n, grainPhase[i], grainPhaseInc[i], grainPos[i], grainInvLen[i], grainAmp[i]);
+			float p = grainPhase[i] + grainPhaseInc[i] * n;
+			grainPhase[i] = p - (float)(int)p;
+			grainPos[i] += (float)n;
+		}
+		grainDelay[i] = std::max(0, grainDelay[i] - frames);
+
+		if (grainPos[i] >= grainLength[i]) {
+			// Retire: move the last active grain into this slot (keeps the pool compacted).
+			const size_t last = (size_t)--activeCount;
+			grainPhase[i] = grainPhase[last];
+			grainPhaseInc[i] = grainPhaseInc[last];
+			grainPos[i] = grainPos[last];
+			grainLength[i] = grainLength[last];
+			grainInvLen[i] = grainInvLen[last];
+			grainAmp[i] = grainAmp[last];
+			grainDelay[i] = grainDelay[last];
+			continue; // re-process the moved grain in this slot
+		}
+		g++;
+	}
+}
+
+void GranularSynth::mixGrain(float * __restrict dst, int n, float phase, float phaseInc, float pos, float invLen, float amp) {
+	// Branch-free body: vectorizes across samples.
+	for (int i = 0; i < n; i++) {
+		// Phase in cycles -> x in [-1, 1)
+		float p = phase + phaseInc * (float)i;
+		p -= (float)(int)p;
+		const float x = 2.0f * p - 1.0f;
+		// Parabolic sine approximation with one refinement step (error < 0.1%).
+		float s = 4.0f * x * (1.0f - std::abs(x));
+		s = 0.225f * (s * std::abs(s) - s) + s;
+		// Parabolic (Welch) window over the grain length.
+		const float t = (pos + (float)i) * invLen;
+		const float w = std::max(0.0f, 4.0f * t * (1.0f - t));
+		dst[i] -= s * w * amp; // x = 2p-1 shifts the phase by half a cycle; negate to keep sin(2*pi*p)
+	}
+}
+
+float GranularSynth::random01() {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (rng >> 8) * (1.0f / 16777216.0f);
+}
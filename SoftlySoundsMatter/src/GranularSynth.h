@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Textural synthesis: bright pixels around the playhead emit short sine grains.
+// - row -> grain pitch (shared `rowToFrequency()` mapping)
+// - brightness -> grain density (grains per second for that row)
+//
+// Grains live in a fixed-capacity structure-of-arrays pool (no heap allocation in the audio callback).
+// Spawning is sample-accurate: each row keeps a countdown to its next grain in samples.
+// Mixing is grain-major with a branch-free polynomial sine and parabolic window, so the inner loop
+// vectorizes and thousands of concurrent grains fit in a callback.
+class GranularSynth {
+public:
+	/// Pool capacity: maximum concurrent grains (new grains are dropped when full).
+	static constexpr int kMaxGrains = 4096;
+
+	/// Configure the synthesis engine with the audio stream sample rate.
+	void setup(float sampleRate);
+	/// Set runtime parameters controlling volume and frequency range mapping.
+	void setParams(float volume, float minFreq, float maxFreq);
+	/// Set grain shape/density.
+	/// @param density Grains per second emitted by a fully bright row.
+	/// @param grainMs Grain length in milliseconds.
+	/// @param columnRadius Columns on each side of the playhead that contribute grains.
+	void setGrainParams(float density, float grainMs, int columnRadius);
+
+	/// Render grains emitted around `columnX` into `out` (same signal on every channel).
+	/// Outputs silence when inputs are invalid.
+	void renderColumnToBuffer(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, ofSoundBuffer & out);
+
+	/// Number of grains currently sounding (audio thread value; approximate when read elsewhere).
+	int getActiveGrainCount() const { return activeCount; }
+
+private:
+	float sampleRate = 44100.0f;
+	float volume = 0.5f;
+	float minFreq = 100.0f;
+	float maxFreq = 4000.0f;
+	float brightnessThreshold = 0.1f;
+
+	float density = 40.0f;
+	float grainMs = 60.0f;
+	int columnRadius = 2;
+
+	// Grain pool (structure of arrays). Active grains are kept compacted in [0, activeCount).
+	std::array<float, kMaxGrains> grainPhase {};    // cycles, [0,1)
+	std::array<float, kMaxGrains> grainPhaseInc {}; // cycles per sample
+	std::array<float, kMaxGrains> grainPos {};      // samples elapsed in the grain
+	std::array<float, kMaxGrains> grainInvLen {};   // 1 / length in samples
+	std::array<float, kMaxGrains> grainLength {};   // samples
+	std::array<float, kMaxGrains> grainAmp {};
+	std::array<int, kMaxGrains> grainDelay {};      // samples into the current buffer before the grain starts
+	int activeCount = 0;
+
+	// Scheduler state (per image row)
+	std::vector<float> nextSpawn;   // samples until the next grain of this row
+	std::vector<float> rowDensity;  // scratch: brightness around the playhead per row
+
+	std::vector<float> mixBuffer;   // mono scratch, grows to the largest buffer seen
+	float smoothedGain = 0.0f;
+	uint32_t rng = 0x9e3779b9u;
+
+	/// Fill `rowDensity` with the brightest value per row across the playhead neighbourhood.
+	void scanNeighbourhood(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX);
+	/// Spawn this buffer's grains at sample-accurate offsets.
+	void scheduleGrains(int imgHeight, int frames);
+	/// Add one grain to the pool (dropped when full).
+	void spawnGrain(int row, int imgHeight, float brightness, int delay);
+	/// Mix all active grains into `mixBuffer` and retire finished ones.
+	void mixGrains(int frames);
+	/// Mix one grain over `n` samples starting at `dst`.
+	static void mixGrain(float * __restrict dst, int n, float phase, float phaseInc, float pos, float invLen, float amp);
+	/// Uniform random value in [0,1) (xorshift; audio-thread safe).
+	float random01();
+};
@@ -0,0 +1,149 @@
+#include "ImageFileLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Opt-in: build with -DSSM_USE_LIBJPEG=1 and link -ljpeg (libjpeg or libjpeg-turbo).
+#if defined(SSM_USE_LIBJPEG) && SSM_USE_LIBJPEG && defined(__has_include)
+#if __has_include(<jpeglib.h>)
+#define SSM_HAVE_LIBJPEG 1
+#include <csetjmp>
+#include <jpeglib.h>
+#endif
+#endif
+
+ImageFileLoader::~ImageFileLoader() {
+	close();
+}
+
+void ImageFileLoader::load(const std::string & path, float targetScale) {
+	close();
+	loadDone = false;
+	worker = std::thread(&ImageFileLoader::decodeWorker, this, path, targetScale);
+}
+
+bool ImageFileLoader::poll(Result & out, bool & ok) {
+	if (!worker.joinable() || !loadDone.load()) return false;
+	worker.join();
+	ok = loadOk;
+	out = std::move(loaded);
+	loaded = Result();
+	return true;
+}
+
+void ImageFileLoader::close() {
+	if (!worker.joinable()) return;
+	cancel = true;
+	worker.join();
+	cancel = false;
+	loaded = Result();
+}
+
+void ImageFileLoader::decodeWorker(std::string path, float targetScale) {
+	Result result;
+	loadOk = decodeGray(path, targetScale, result, &cancel);
+	loaded = std::move(result);
+	loadDone = true;
+}
+
+bool ImageFileLoader::decodeGray(const std::string & path, float targetScale, Result & out, const std::atomic<bool> * cancel) {
+	targetScale = ofClamp(targetScale, 0.01f, 1.0f);
+	out.path = path;
+	if (decodeJpegScaled(path, targetScale, out, cancel)) return true;
+	if (cancel && cancel->load()) return false;
+	return decodeGeneric(path, targetScale, out);
+}
+
+#if defined(SSM_HAVE_LIBJPEG)
+namespace {
+struct JpegError {
+	jpeg_error_mgr pub;
+	std::jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+	std::longjmp(reinterpret_cast<JpegError *>(cinfo->err)->jump, 1);
+}
+
+void jpegSilence(j_common_ptr) {
+}
+}
+
+bool ImageFileLoader::decodeJpegScaled(const std::string & path, float targetScale, Result & out, const std::atomic<bool> * cancel) {
+	FILE * file = std::fopen(path.c_str(), "rb");
+	if (!file) return false;
+
+	// Everything touched after setjmp() is trivially destructible or lives outside this frame.
+	jpeg_decompress_struct cinfo;
+	JpegError err;
+	cinfo.err = jpeg_std_error(&err.pub);
+	err.pub.error_exit = jpegErrorExit;
+	err.pub.output_message = jpegSilence;
+	if (setjmp(err.jump)) {
+		// Not a JPEG, unsupported colour space (e.g. CMYK) or corrupt data: let the generic loader try.
+		jpeg_destroy_decompress(&cinfo);
+		std::fclose(file);
+		return false;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_stdio_src(&cinfo, file);
+	jpeg_read_header(&cinfo, TRUE);
+
+	// Smallest supported IDCT scale that still covers the target; ImageProcessor does the final resize.
+	// (libjpeg-turbo / libjpeg 8 honour any N/8; libjpeg 6b rounds up to 1/8, 1/4, 1/2 or 1/1.)
+	cinfo.scale_num = (unsigned int)ofClamp((int)std::ceil(targetScale * 8.0f), 1, 8);
+	cinfo.scale_denom = 8;
+	cinfo.out_color_space = JCS_GRAYSCALE;
+	cinfo.dct_method = JDCT_IFAST;
+	jpeg_calc_output_dimensions(&cinfo);
+
+	out.gray.allocate(cinfo.output_width, cinfo.output_height, OF_PIXELS_GRAY);
+	out.sourceScale = (float)cinfo.output_width / (float)std::max(1u, (unsigned int)cinfo.image_width);
+
+	jpeg_start_decompress(&cinfo);
+	const size_t stride = cinfo.output_width;
+	while (cinfo.output_scanline < cinfo.output_height) {
+		if (cancel && cancel->load()) {
+			jpeg_abort_decompress(&cinfo);
+			jpeg_destroy_decompress(&cinfo);
+			std::fclose(file);
+			return false;
+		}
+		JSAMPROW row = out.gray.getData() + (size_t)cinfo.output_scanline * stride;
+		jpeg_read_scanlines(&cinfo, &row, 1);
+	}
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+	std::fclose(file);
+	return true;
+}
+#else
+bool ImageFileLoader::decodeJpegScaled(const std::string &, float, Result &, const std::atomic<bool> *) {
+	return false;
+}
+#endif
+
+bool ImageFileLoader::decodeGeneric(const std::string & path, float targetScale, Result & out) {
+	// Ask FreeImage for luminance directly (honoured for JPEGs; other formats are converted below).
+	ofImageLoadSettings settings;
+	settings.grayscale = true;
+	ofPixels pix;
+	if (!ofLoadImage(pix, path, settings)) {
+		ofLogError("ImageFileLoader") << "Can't load " << path;
+		return false;
+	}
+	if (pix.getImageType() != OF_IMAGE_GRAYSCALE) pix.setImageType(OF_IMAGE_GRAYSCALE);
+
+	const int w = std::max(1, (int)std::ceil(pix.getWidth() * targetScale));
+	const int h = std::max(1, (int)std::ceil(pix.getHeight() * targetScale));
+	out.sourceScale = (float)w / (float)std::max(1, (int)pix.getWidth());
+	if (w != (int)pix.getWidth() || h != (int)pix.getHeight()) {
+		out.gray.allocate(w, h, OF_PIXELS_GRAY);
+		pix.resizeTo(out.gray);
+	} else {
+		out.gray = std::move(pix);
+	}
+	return true;
+}
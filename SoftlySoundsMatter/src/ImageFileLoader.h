@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Decodes image files straight to a small grayscale bitmap on a background thread.
+// JPEGs are decoded with libjpeg's scaled IDCT (1/8 .. 8/8) when the app is built with
+// SSM_USE_LIBJPEG=1, so a 24 MP scan never exists at full resolution in memory.
+// Other formats (and builds without libjpeg) go through ofLoadImage() and are downscaled on the worker.
+class ImageFileLoader {
+public:
+	// One decoded image.
+	struct Result {
+		ofPixels gray;           // OF_PIXELS_GRAY, at least `targetScale` x the file's size (when possible)
+		float sourceScale = 1.0f; // gray size / full file size
+		std::string path;
+	};
+
+	ImageFileLoader() = default;
+	~ImageFileLoader();
+
+	// Non-copyable (owns a worker thread)
+	ImageFileLoader(const ImageFileLoader &) = delete;
+	ImageFileLoader & operator=(const ImageFileLoader &) = delete;
+
+	/// Main thread: start decoding `path` at roughly `targetScale` of its full size.
+	/// Any in-flight load is cancelled.
+	void load(const std::string & path, float targetScale);
+	/// Main thread: if a load has finished, move it into `out` and return true.
+	/// @param ok Set to false when the file could not be decoded.
+	bool poll(Result & out, bool & ok);
+	/// Cancel and join any in-flight load.
+	void close();
+
+	/// True while a file is being decoded.
+	bool isLoading() const { return worker.joinable(); }
+
+	/// Decode `path` synchronously (any thread). Tries the scaled JPEG path first, then ofLoadImage().
+	/// @param cancel Optional flag polled between scanlines.
+	static bool decodeGray(const std::string & path, float targetScale, Result & out, const std::atomic<bool> * cancel = nullptr);
+
+private:
+	std::thread worker;
+	std::atomic<bool> cancel { false };
+	std::atomic<bool> loadDone { false };
+	bool loadOk = false;
+	Result loaded;
+
+	/// Worker entry point.
+	void decodeWorker(std::string path, float targetScale);
+
+	/// libjpeg scaled IDCT decode to grayscale. Returns false for non-JPEG files or decode errors.
+	static bool decodeJpegScaled(const std::string & path, float targetScale, Result & out, const std::atomic<bool> * cancel);
+	/// Generic fallback: ofLoadImage(), grayscale conversion, then downscale to `targetScale`.
+	static bool decodeGeneric(const std::string & path, float targetScale, Result & out);
+};
@@ -3,14 +3,65 @@
 #include <algorithm>
 #include <cmath>
 
+namespace {
+// Bump when the processing pipeline changes so stale cache entries are never reused.
+constexpr uint32_t kPipelineVersion = 1;
+}
+
 void ImageProcessor::setSourceRGB(const ofPixels & rgb) {
 	if (!rgb.isAllocated()) return;
 	original.setFromPixels(rgb);
 	original.update();
+	sourceScale = 1.0f;
+	cameraSource = true;
+	hashSource();
+	allocateProcessedImages();
+	dirty = true;
+}
+
+void ImageProcessor::setSourceGray(const ofPixels & gray, float scale) {
+	if (!gray.isAllocated() || gray.getNumChannels() != 1) return;
+	original.setFromPixels(gray);
+	original.update();
+	sourceScale = ofClamp(scale, 0.001f, 1.0f);
+	cameraSource = false;
+	hashSource();
 	allocateProcessedImages();
 	dirty = true;
 }
 
+bool ImageProcessor::loadFromFile(const std::string & path) {
+	ImageFileLoader::Result result;
+	if (!ImageFileLoader::decodeGray(ofToDataPath(path), scaleFactor, result)) return false;
+	setSourceGray(result.gray, result.sourceScale);
+	return true;
+}
+
+void ImageProcessor::loadFromFileAsync(const std::string & path, std::function<void(bool, const std::string &)> onReady) {
+	onLoadReady = std::move(onReady);
+	loader.load(ofToDataPath(path), scaleFactor);
+}
+
+void ImageProcessor::setKeystone(const Keystone::Corners & corners) {
+	if (corners == keystone.getCorners()) return;
+	keystone.setCorners(corners);
+	if (cameraSource) dirty = true;
+}
+
+void ImageProcessor::setColorPlanesEnabled(bool enabled) {
+	if (enabled == colorPlanesEnabled) return;
+	colorPlanesEnabled = enabled;
+	if (!enabled) {
+		colorPlanes.clear();
+		colorPlanesKey = 0;
+	}
+	dirty = true;
+}
+
+void ImageProcessor::enableFeatureCache(const std::string & dir, uint64_t budgetBytes) {
+	featureCache.setup(dir, budgetBytes);
+}
+
 void ImageProcessor::setParams(float contrast, float exposure, float sobelStrength) {
 	if (contrast != lastContrast || exposure != lastExposure || sobelStrength != lastSobelStrength) {
 		lastContrast = contrast;
@@ -21,6 +72,14 @@ void ImageProcessor::setParams(float contrast, float exposure, float sobelStreng
 }
 
 void ImageProcessor::update() {
+	ImageFileLoader::Result loaded;
+	bool ok = false;
+	if (loader.poll(loaded, ok)) {
+		if (ok) setSourceGray(loaded.gray, loaded.sourceScale);
+		if (onLoadReady) onLoadReady(ok, loaded.path);
+	}
+	featureCache.update(ofGetElapsedTimeMillis());
+
 	if (!dirty || !original.isAllocated()) return;
 	process();
 	dirty = false;
@@ -35,19 +94,138 @@ float ImageProcessor::calculateDrawScale(float windowW, float windowH) const {
 }
 
 void ImageProcessor::allocateProcessedImages() {
-	const int w = std::max(1, (int)(original.getWidth() * scaleFactor));
-	const int h = std::max(1, (int)(original.getHeight() * scaleFactor));
+	// Sizes are relative to the full-resolution source, even when `original` was decoded smaller.
+	const float s = scaleFactor / sourceScale;
+	const int w = std::max(1, (int)(original.getWidth() * s + 0.001f));
+	const int h = std::max(1, (int)(original.getHeight() * s + 0.001f));
+	releaseMappedSobel();
 	graySmall.allocate(w, h, OF_IMAGE_GRAYSCALE);
 	sobelImg.allocate(w, h, OF_IMAGE_GRAYSCALE);
 }
 
 void ImageProcessor::process() {
-	resizeToGrayscale();
-	applyImageAdjustments(lastContrast, lastExposure);
-	applySobelFilter(lastSobelStrength);
+	const uint64_t key = featureKey();
+	if (featureCache.lookup(key, graySmall.getWidth(), graySmall.getHeight(), sobelImg.getPixels())) {
+		// Cache hit: `sobelImg` now points into the mapped file (no copy); only the texture is uploaded.
+		sobelMapped = true;
+		sobelImg.update();
+	} else {
+		releaseMappedSobel();
+		resizeToGrayscale();
+		applyImageAdjustments(lastContrast, lastExposure);
+		applySobelFilter(lastSobelStrength);
+		featureCache.scheduleStore(key, sobelImg.getPixels(), ofGetElapsedTimeMillis());
+	}
+	updateColorPlanes();
+	generation++;
+}
+
+void ImageProcessor::hashSource() {
+	const ofPixels & pix = original.getPixels();
+	uint64_t h = FeatureCache::hash(pix.getData(), pix.size());
+	h = FeatureCache::hashValue((uint64_t)pix.getWidth(), h);
+	h = FeatureCache::hashValue((uint64_t)pix.getHeight(), h);
+	sourceHash = FeatureCache::hashValue((uint64_t)pix.getNumChannels(), h);
+}
+
+uint64_t ImageProcessor::featureKey() const {
+	uint64_t h = FeatureCache::hashValue(sourceHash, FeatureCache::kFnvOffset);
+	h = FeatureCache::hashValue(kPipelineVersion, h);
+	h = FeatureCache::hashValue(scaleFactor, h);
+	h = FeatureCache::hashValue(sourceScale, h);
+	h = FeatureCache::hashValue(lastContrast, h);
+	h = FeatureCache::hashValue(lastExposure, h);
+	h = FeatureCache::hashValue(lastSobelStrength, h);
+	if (cameraSource) h = FeatureCache::hashValue(keystone.getCorners(), h);
+	return h;
+}
+
+uint64_t ImageProcessor::colorGeometryKey() const {
+	uint64_t h = FeatureCache::hashValue(sourceHash, FeatureCache::kFnvOffset);
+	h = FeatureCache::hashValue(scaleFactor, h);
+	h = FeatureCache::hashValue(sourceScale, h);
+	return FeatureCache::hashValue(keystone.getCorners(), h);
+}
+
+void ImageProcessor::updateColorPlanes() {
+	const int w = graySmall.getWidth();
+	const int h = graySmall.getHeight();
+	if (!colorPlanesEnabled || !cameraSource) {
+		colorPlanes.clear();
+		colorPlanesKey = 0;
+		return;
+	}
+	const uint64_t key = colorGeometryKey();
+	if (key == colorPlanesKey && colorPlanes.matches(w, h)) return;
+
+	ofPixels rgb;
+	rgb.allocate(w, h, OF_PIXELS_RGB);
+	if (!keystone.isIdentity()) {
+		keystone.remapToRGB(original.getPixels(), rgb);
+	} else {
+		original.getPixels().resizeTo(rgb);
+	}
+	computeHueSaturation(rgb, colorPlanes);
+	colorPlanesKey = key;
+}
+
+void ImageProcessor::computeHueSaturation(const ofPixels & rgb, ColorPlanes & planes) {
+	const int w = rgb.getWidth();
+	const int h = rgb.getHeight();
+	planes.width = w;
+	planes.height = h;
+	planes.hue.resize((size_t)w * h);
+	planes.saturation.resize((size_t)w * h);
+
+	// Integer HSV (hue in 1/256 turns). Reads rows, writes columns: the transpose happens here once so
+	// the audio thread can read each column contiguously.
+	const unsigned char * src = rgb.getData();
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++, src += 3) {
+			const int r = src[0], g = src[1], b = src[2];
+			const int maxC = std::max(r, std::max(g, b));
+			const int minC = std::min(r, std::min(g, b));
+			const int d = maxC - minC;
+			int hue = 0;
+			if (d > 0) {
+				if (maxC == r) hue = (43 * (g - b)) / d;
+				else if (maxC == g) hue = 85 + (43 * (b - r)) / d;
+				else hue = 171 + (43 * (r - g)) / d;
+			}
+			const size_t i = (size_t)x * h + y;
+			planes.hue[i] = (uint8_t)(hue & 0xff);
+			planes.saturation[i] = (uint8_t)(maxC > 0 ? (255 * d) / maxC : 0);
+		}
+	}
+}
+
+void ImageProcessor::releaseMappedSobel() {
+	if (!sobelMapped) return;
+	// clear() drops the external pointer without freeing it; allocate() then owns a fresh buffer.
+	const int w = std::max(1, (int)sobelImg.getWidth());
+	const int h = std::max(1, (int)sobelImg.getHeight());
+	sobelImg.getPixels().clear();
+	sobelImg.allocate(w, h, OF_IMAGE_GRAYSCALE);
+	sobelMapped = false;
 }
 
 void ImageProcessor::resizeToGrayscale() {
+	const ofPixels & src = original.getPixels();
+	if (cameraSource && !keystone.isIdentity()) {
+		// Perspective correction and downscale in one LUT-driven pass.
+		keystone.remapToGray(src, graySmall.getPixels());
+		return;
+	}
+	if (src.getNumChannels() == 1) {
+		// Grayscale source (decoded from a file): already near the target size.
+		if (src.getWidth() == graySmall.getWidth() && src.getHeight() == graySmall.getHeight()) {
+			graySmall.setFromPixels(src);
+		} else {
+			src.resizeTo(graySmall.getPixels());
+		}
+		return;
+	}
+
 	ofPixels resized;
 	resized.allocate(graySmall.getWidth(), graySmall.getHeight(), OF_PIXELS_RGB);
 	original.getPixels().resizeTo(resized);
@@ -2,6 +2,14 @@
 
 #include "ofMain.h"
 
+#include "ColorPlanes.h"
+#include "FeatureCache.h"
+#include "ImageFileLoader.h"
+#include "Keystone.h"
+
+#include <cstdint>
+#include <functional>
+
 // Owns the current source image and processed Sobel image.
 // The processing pipeline is intentionally simple: resize -> grayscale -> exposure/contrast -> Sobel.
 class ImageProcessor {
@@ -14,10 +22,34 @@ public:
 	/// Set a new RGB source image (e.g. captured from the camera). Allocates internal buffers and marks processing dirty.
 	void setSourceRGB(const ofPixels & rgb);
 
-	/// Load an image from disk and set it as the source image.
+	/// Set a grayscale source that was already downscaled at decode time.
+	/// @param sourceScale Size of `gray` relative to the full-resolution image (1.0 = full size).
+	void setSourceGray(const ofPixels & gray, float sourceScale = 1.0f);
+
+	/// Load an image from disk (decoded at the processing scale, straight to grayscale) and set it as the source.
+	/// Blocks the caller; prefer `loadFromFileAsync()` on the main thread.
 	/// @return false if load failed.
-	/// @note Declared but not currently implemented in `ImageProcessor.cpp`.
 	bool loadFromFile(const std::string & path);
+	/// Decode an image on a background thread. `onReady(ok, path)` is called from `update()` once the
+	/// new source is in place (or the load failed). A newer request cancels an in-flight one.
+	void loadFromFileAsync(const std::string & path, std::function<void(bool, const std::string &)> onReady = nullptr);
+	/// True while an asynchronous load is in flight.
+	bool isLoading() const { return loader.isLoading(); }
+
+	/// Set the keystone (perspective) correction applied to camera sources (`setSourceRGB`).
+	/// Marks processing dirty when the corners change.
+	void setKeystone(const Keystone::Corners & corners);
+	/// Current keystone correction.
+	const Keystone & getKeystone() const { return keystone; }
+
+	/// Also compute hue/saturation planes (camera sources only; file sources are decoded as gray).
+	void setColorPlanesEnabled(bool enabled);
+	bool isColorPlanesEnabled() const { return colorPlanesEnabled; }
+	/// Column-major hue/saturation planes matching the Sobel image (empty when disabled or unavailable).
+	const ColorPlanes & getColorPlanes() const { return colorPlanes; }
+
+	/// Persist processed maps in `dir` (keyed by source content + parameters) and reuse them on later runs.
+	void enableFeatureCache(const std::string & dir, uint64_t budgetBytes = FeatureCache::kDefaultBudgetBytes);
 
 	/// Update processing parameters; marks dirty only when values change.
 	/// @param contrast Multiplier around midpoint (1.0 = no change).
@@ -25,7 +57,7 @@ public:
 	/// @param sobelStrength Scales the Sobel magnitude before clamping to [0..255].
 	void setParams(float contrast, float exposure, float sobelStrength);
 
-	/// Run processing if needed (when dirty and a source image is available).
+	/// Deliver finished asynchronous loads, then run processing if needed (when dirty and a source image is available).
 	void update();
 
 	/// True when a source image has been loaded/captured.
@@ -43,6 +75,8 @@ public:
 	int getWidth() const { return sobelImg.getWidth(); }
 	/// Processed image height in pixels.
 	int getHeight() const { return sobelImg.getHeight(); }
+	/// Incremented every time the Sobel image is re-processed (lets consumers detect content changes).
+	uint64_t getGeneration() const { return generation; }
 
 	/// Compute a draw scale that fills the target window while keeping aspect ratio (cover scaling; may crop).
 	float calculateDrawScale(float windowW, float windowH) const;
@@ -53,19 +87,50 @@ private:
 	ofImage sobelImg;
 
 	float scaleFactor = 0.25f;
+	float sourceScale = 1.0f; // size of `original` relative to the full-resolution source
+	uint64_t sourceHash = 0;  // content hash of `original` (feature cache key)
+	bool cameraSource = false; // keystone correction applies to camera captures only
+
+	Keystone keystone;
+
+	// Optional color feature planes (recomputed only when the source or geometry changes).
+	bool colorPlanesEnabled = false;
+	ColorPlanes colorPlanes;
+	uint64_t colorPlanesKey = 0;
 	bool dirty = true;
+	uint64_t generation = 0;
 
 	// Cached params for change detection
 	float lastContrast = 1.0f;
 	float lastExposure = 0.0f;
 	float lastSobelStrength = 1.0f;
 
+	// Persistent processed maps; `sobelMapped` is set while `sobelImg` points into a cache mapping.
+	FeatureCache featureCache;
+	bool sobelMapped = false;
+
+	// Background file decoding
+	ImageFileLoader loader;
+	std::function<void(bool, const std::string &)> onLoadReady;
+
 	/// Allocate `graySmall` and `sobelImg` based on current source size and `scaleFactor`.
 	void allocateProcessedImages();
-	/// Run the full processing pipeline into `sobelImg`.
+	/// Run the full processing pipeline into `sobelImg` (or map it from the feature cache).
 	void process();
-
-	/// Downscale the source image and convert to grayscale into `graySmall`.
+	/// Hash the current `original` pixels into `sourceHash`.
+	void hashSource();
+	/// Feature cache key for the current source and parameters.
+	uint64_t featureKey() const;
+	/// Geometry key of the color planes (source, scale, keystone); parameters don't affect them.
+	uint64_t colorGeometryKey() const;
+	/// Recompute `colorPlanes` if enabled and stale.
+	void updateColorPlanes();
+	/// Convert interleaved RGB into column-major hue/saturation planes.
+	static void computeHueSaturation(const ofPixels & rgb, ColorPlanes & planes);
+	/// Give `sobelImg` its own pixel buffer again if it points into a cache mapping.
+	void releaseMappedSobel();
+
+	/// Downscale the source image and convert to grayscale into `graySmall` (keystone-corrected for camera sources).
 	void resizeToGrayscale();
 	/// Apply exposure/contrast adjustments to `graySmall` in-place.
 	void applyImageAdjustments(float contrast, float exposure);
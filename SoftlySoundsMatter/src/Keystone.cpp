@@ -0,0 +1,190 @@
+#include "Keystone.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Integer luma (BT.601 weights / 256).
+inline int lumaAt(const unsigned char * p, size_t channels) {
+	return channels >= 3 ? (77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8 : p[0];
+}
+
+// Fixed-point bilinear gather over the LUT; `Channels` is a template parameter so the tap loads
+// compile to fixed offsets.
+template <size_t Channels>
+void remapRows(const unsigned char * src, size_t srcStride, const uint32_t * offsets, const uint16_t * fracs,
+               unsigned char * dst, size_t count, uint32_t outside) {
+	for (size_t i = 0; i < count; i++) {
+		const uint32_t off = offsets[i];
+		if (off == outside) {
+			dst[i] = 0;
+			continue;
+		}
+		const unsigned char * p = src + (size_t)off * Channels;
+		const int fx = fracs[i] & 0xff;
+		const int fy = fracs[i] >> 8;
+		const int a = lumaAt(p, Channels);
+		const int b = lumaAt(p + Channels, Channels);
+		const int c = lumaAt(p + srcStride, Channels);
+		const int d = lumaAt(p + srcStride + Channels, Channels);
+		const int top = a * (256 - fx) + b * fx;
+		const int bottom = c * (256 - fx) + d * fx;
+		dst[i] = (unsigned char)((top * (256 - fy) + bottom * fy + 32768) >> 16);
+	}
+}
+
+// Color variant: blends R, G and B separately into an interleaved RGB destination.
+template <size_t Channels>
+void remapRowsRGB(const unsigned char * src, size_t srcStride, const uint32_t * offsets, const uint16_t * fracs,
+                  unsigned char * dst, size_t count, uint32_t outside) {
+	for (size_t i = 0; i < count; i++, dst += 3) {
+		const uint32_t off = offsets[i];
+		if (off == outside) {
+			dst[0] = dst[1] = dst[2] = 0;
+			continue;
+		}
+		const unsigned char * p = src + (size_t)off * Channels;
+		const int fx = fracs[i] & 0xff;
+		const int fy = fracs[i] >> 8;
+		for (size_t c = 0; c < 3; c++) {
+			const int top = p[c] * (256 - fx) + p[Channels + c] * fx;
+			const int bottom = p[srcStride + c] * (256 - fx) + p[srcStride + Channels + c] * fx;
+			dst[c] = (unsigned char)((top * (256 - fy) + bottom * fy + 32768) >> 16);
+		}
+	}
+}
+}
+
+Keystone::Corners Keystone::identityCorners() {
+	return { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(1.0f, 1.0f), glm::vec2(0.0f, 1.0f) };
+}
+
+void Keystone::setCorners(const Corners & c) {
+	if (c == corners) return;
+	corners = c;
+	lutDirty = true;
+}
+
+bool Keystone::isIdentity() const {
+	return corners == identityCorners();
+}
+
+bool Keystone::loadCorners(const std::string & path, Corners & out) {
+	if (!ofFile::doesFileExist(path)) return false;
+	const ofJson json = ofLoadJson(path);
+	if (!json.contains("corners") || !json["corners"].is_array() || json["corners"].size() != 4) {
+		ofLogWarning("Keystone") << "Ignoring malformed calibration " << path;
+		return false;
+	}
+	Corners c;
+	for (size_t i = 0; i < c.size(); i++) {
+		const auto & p = json["corners"][i];
+		c[i] = glm::vec2(ofClamp(p[0].get<float>(), 0.0f, 1.0f), ofClamp(p[1].get<float>(), 0.0f, 1.0f));
+	}
+	out = c;
+	return true;
+}
+
+bool Keystone::saveCorners(const std::string & path, const Corners & corners) {
+	ofJson json;
+	for (const auto & p : corners) {
+		json["corners"].push_back({ p.x, p.y });
+	}
+	return ofSavePrettyJson(path, json);
+}
+
+bool Keystone::ensureLut(const ofPixels & src, const ofPixels & dst) {
+	const int srcW = (int)src.getWidth();
+	const int srcH = (int)src.getHeight();
+	const int dstW = (int)dst.getWidth();
+	const int dstH = (int)dst.getHeight();
+	if (srcW < 2 || srcH < 2 || dstW < 1 || dstH < 1) return false;
+	if (lutDirty || srcW != lutSrcW || srcH != lutSrcH || dstW != lutDstW || dstH != lutDstH) {
+		buildLut(srcW, srcH, dstW, dstH);
+	}
+	return true;
+}
+
+void Keystone::remapToGray(const ofPixels & src, ofPixels & dst) {
+	if (dst.getNumChannels() != 1 || !ensureLut(src, dst)) return;
+
+	const size_t channels = src.getNumChannels();
+	const size_t stride = src.getWidth() * channels;
+	const size_t count = dst.getWidth() * dst.getHeight();
+	switch (channels) {
+	case 1: remapRows<1>(src.getData(), stride, lutOffset.data(), lutFrac.data(), dst.getData(), count, kOutside); break;
+	case 3: remapRows<3>(src.getData(), stride, lutOffset.data(), lutFrac.data(), dst.getData(), count, kOutside); break;
+	case 4: remapRows<4>(src.getData(), stride, lutOffset.data(), lutFrac.data(), dst.getData(), count, kOutside); break;
+	default: dst.set(0); break;
+	}
+}
+
+void Keystone::remapToRGB(const ofPixels & src, ofPixels & dst) {
+	if (dst.getNumChannels() != 3 || !ensureLut(src, dst)) return;
+
+	const size_t channels = src.getNumChannels();
+	const size_t stride = src.getWidth() * channels;
+	const size_t count = dst.getWidth() * dst.getHeight();
+	switch (channels) {
+	case 3: remapRowsRGB<3>(src.getData(), stride, lutOffset.data(), lutFrac.data(), dst.getData(), count, kOutside); break;
+	case 4: remapRowsRGB<4>(src.getData(), stride, lutOffset.data(), lutFrac.data(), dst.getData(), count, kOutside); break;
+	default: dst.set(0); break;
+	}
+}
+
+void Keystone::buildLut(int srcW, int srcH, int dstW, int dstH) {
+	// Homography from the unit square to the corner quad (Heckbert, "Fundamentals of Texture Mapping").
+	const float x0 = corners[0].x, y0 = corners[0].y;
+	const float x1 = corners[1].x, y1 = corners[1].y;
+	const float x2 = corners[2].x, y2 = corners[2].y;
+	const float x3 = corners[3].x, y3 = corners[3].y;
+	const float dx1 = x1 - x2, dx2 = x3 - x2, dx3 = x0 - x1 + x2 - x3;
+	const float dy1 = y1 - y2, dy2 = y3 - y2, dy3 = y0 - y1 + y2 - y3;
+
+	float a, b, c, d, e, f, g = 0.0f, h = 0.0f;
+	const float den = dx1 * dy2 - dx2 * dy1;
+	if ((dx3 == 0.0f && dy3 == 0.0f) || std::abs(den) < 1e-9f) {
+		// Parallelogram (or degenerate quad): affine map.
+		a = x1 - x0; b = x2 - x1; c = x0;
+		d = y1 - y0; e = y2 - y1; f = y0;
+	} else {
+		g = (dx3 * dy2 - dx2 * dy3) / den;
+		h = (dx1 * dy3 - dx3 * dy1) / den;
+		a = x1 - x0 + g * x1; b = x3 - x0 + h * x3; c = x0;
+		d = y1 - y0 + g * y1; e = y3 - y0 + h * y3; f = y0;
+	}
+
+	const size_t count = (size_t)dstW * dstH;
+	lutOffset.resize(count);
+	lutFrac.resize(count);
+	for (int j = 0; j < dstH; j++) {
+		const float v = (j + 0.5f) / dstH;
+		for (int i = 0; i < dstW; i++) {
+			const float u = (i + 0.5f) / dstW;
+			const float w = g * u + h * v + 1.0f;
+			const size_t k = (size_t)j * dstW + i;
+			// Source pixel coordinates (pixel centres at integer positions).
+			const float sx = (a * u + b * v + c) / w * srcW - 0.5f;
+			const float sy = (d * u + e * v + f) / w * srcH - 0.5f;
+			if (!(sx > -1.0f && sx < (float)srcW && sy > -1.0f && sy < (float)srcH)) {
+				lutOffset[k] = kOutside;
+				lutFrac[k] = 0;
+				continue;
+			}
+			const float cx = ofClamp(sx, 0.0f, (float)(srcW - 1));
+			const float cy = ofClamp(sy, 0.0f, (float)(srcH - 1));
+			const int ix = std::min((int)cx, srcW - 2);
+			const int iy = std::min((int)cy, srcH - 2);
+			const int fx = std::min(255, (int)std::lround((cx - ix) * 256.0f));
+			const int fy = std::min(255, (int)std::lround((cy - iy) * 256.0f));
+			lutOffset[k] = (uint32_t)iy * (uint32_t)srcW + (uint32_t)ix;
+			lutFrac[k] = (uint16_t)(fx | (fy << 8));
+		}
+	}
+
+	lutSrcW = srcW;
+	lutSrcH = srcH;
+	lutDstW = dstW;
+	lutDstH = dstH;
+	lutDirty = false;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Perspective (keystone) correction for camera captures of paper seen at an angle.
+// Four corners (normalized source coordinates, TL/TR/BR/BL) describe where the paper's corners are in
+// the camera frame. `remapToGray()` warps that quad to a rectangle while converting to grayscale, using
+// a fixed-point lookup table built once per (corners, source size, output size). Per frame the cost is
+// one gather + bilinear blend per output pixel, comparable to the plain resize it replaces.
+class Keystone {
+public:
+	using Corners = std::array<glm::vec2, 4>;
+
+	/// Corners of the full frame (no correction).
+	static Corners identityCorners();
+
+	/// Set the paper corners (normalized [0..1] source coordinates, order TL, TR, BR, BL).
+	void setCorners(const Corners & corners);
+	const Corners & getCorners() const { return corners; }
+	/// True when the corners are the full frame (callers can skip the remap).
+	bool isIdentity() const;
+
+	/// Read corners from a JSON calibration file written by `saveCorners()`. Leaves `out` unchanged on failure.
+	static bool loadCorners(const std::string & path, Corners & out);
+	/// Write corners as JSON (`{"corners": [[x, y], ...]}`).
+	static bool saveCorners(const std::string & path, const Corners & corners);
+
+	/// Warp `src` (RGB or gray) into the already allocated gray `dst`, sampling bilinearly.
+	/// Rebuilds the lookup table when the corners or either size changed.
+	void remapToGray(const ofPixels & src, ofPixels & dst);
+	/// Same warp for color sources: `src` RGB/RGBA into the already allocated RGB `dst`.
+	void remapToRGB(const ofPixels & src, ofPixels & dst);
+
+private:
+	// LUT entry for output pixels that fall outside the source frame.
+	static constexpr uint32_t kOutside = 0xFFFFFFFFu;
+
+	Corners corners = identityCorners();
+
+	// Per output pixel: index of the top-left source tap, and 8.8 fixed-point fractions (fx | fy << 8).
+	std::vector<uint32_t> lutOffset;
+	std::vector<uint16_t> lutFrac;
+	int lutSrcW = 0;
+	int lutSrcH = 0;
+	int lutDstW = 0;
+	int lutDstH = 0;
+	bool lutDirty = true;
+
+	/// Rebuild the lookup table for the given sizes from the current corners.
+	void buildLut(int srcW, int srcH, int dstW, int dstH);
+	/// Rebuild the table if the corners or sizes changed. Returns false for unusable sizes.
+	bool ensureLut(const ofPixels & src, const ofPixels & dst);
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <array>
+#include <cmath>
+
+// Row -> pitch mapping shared by the synthesis engines.
+// A 6-note scale repeated over 4 octaves from C3, with the top row highest, then linearly mapped
+// from the natural C3..C7 range into [minFreq..maxFreq].
+inline float rowToFrequency(int y, int totalHeight, float minFreq, float maxFreq) {
+	// Static: this runs on the audio thread.
+	static const std::array<float, 6> scale = { 0, 3, 5, 7, 10, 12 };
+	float normalizedY = 1.0f;
+	if (totalHeight > 1) normalizedY = 1.0f - (float)y / (totalHeight - 1);
+
+	const int octaveCount = 4;
+	const int totalNotes = (int)scale.size() * octaveCount;
+	const int noteIndex = (int)(normalizedY * (totalNotes - 1));
+	const int octave = noteIndex / (int)scale.size();
+	const int scaleNote = (int)scale[noteIndex % (int)scale.size()];
+
+	const float midiNote = 48 + octave * 12 + scaleNote; // C3 base
+	const float baseFreq = 440.0f * std::pow(2.0f, (midiNote - 69) / 12.0f);
+	return ofMap(baseFreq, 130.8128f, 2093.0045f, minFreq, maxFreq, true);
+}
@@ -0,0 +1,195 @@
+#include "ScanCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+ScanCache::~ScanCache() {
+	close();
+}
+
+void ScanCache::setup(float sr) {
+	close();
+	sampleRate = sr;
+}
+
+void ScanCache::close() {
+	invalidate();
+	stopWorker();
+	hasJob = false;
+	std::vector<float>().swap(frames);
+	std::vector<float>().swap(rendered);
+}
+
+void ScanCache::setEnabled(bool e) {
+	if (e == enabled) return;
+	enabled = e;
+	if (!enabled) {
+		invalidate();
+		stopWorker();
+		hasJob = false;
+	}
+}
+
+void ScanCache::update(const Key & key, const ofPixels & pixels, int imgWidth, int imgHeight, const ColorPlanes * planes,
+                       float playheadX, uint64_t nowMs) {
+	if (!enabled) return;
+
+	if (key != pendingKey) {
+		pendingKey = key;
+		pendingSinceMs = nowMs;
+	}
+
+	// Any parameter change: drop back to live synthesis immediately.
+	if (hasJob && pendingKey != currentKey) {
+		invalidate();
+		stopWorker();
+		hasJob = false;
+	}
+
+	if (!hasJob) {
+		if (pendingKey.playheadSpeed == 0.0f || pendingKey.canvasWidth <= 0.0f) return;
+		if (!pixels.isAllocated() || imgWidth <= 0 || imgHeight <= 0) return;
+		if (nowMs - pendingSinceMs < kSettleMs) return;
+
+		currentKey = pendingKey;
+		hasJob = true;
+		cancel = false;
+		renderDone = false;
+		renderOk = false;
+		progress = 0.0f;
+		// Pixels are copied into the job so the worker never races with ImageProcessor.
+		worker = std::thread(&ScanCache::renderSweep, this, currentKey, pixels, imgWidth, imgHeight,
+		                     (currentKey.colorSound && planes) ? *planes : ColorPlanes());
+		return;
+	}
+
+	if (worker.joinable() && renderDone.load()) {
+		worker.join();
+		if (renderOk.load()) publish(playheadX);
+	}
+}
+
+bool ScanCache::render(ofSoundBuffer & out) {
+	reading.store(true);
+	if (!valid.load()) {
+		reading.store(false);
+		return false;
+	}
+
+	const size_t channels = out.getNumChannels();
+	if (channels != framesChannels) {
+		reading.store(false);
+		return false;
+	}
+
+	// Interleaved layouts match: copy contiguous runs up to the loop point.
+	const size_t numFrames = out.getNumFrames();
+	const size_t sweepFrames = frames.size() / framesChannels;
+	float * dst = out.getBuffer().data();
+	size_t done = 0;
+	while (done < numFrames) {
+		const size_t n = std::min(numFrames - done, sweepFrames - readFrame);
+		std::copy_n(frames.data() + readFrame * channels, n * channels, dst + done * channels);
+		done += n;
+		readFrame += n;
+		if (readFrame >= sweepFrames) readFrame = 0;
+	}
+
+	reading.store(false);
+	return true;
+}
+
+void ScanCache::invalidate() {
+	valid.store(false);
+	// The audio thread may be mid-copy; wait for it before touching `frames`.
+	while (reading.load()) std::this_thread::yield();
+}
+
+void ScanCache::stopWorker() {
+	if (!worker.joinable()) return;
+	cancel = true;
+	worker.join();
+	cancel = false;
+}
+
+void ScanCache::publish(float playheadX) {
+	invalidate();
+	frames.swap(rendered);
+	std::vector<float>().swap(rendered);
+	framesChannels = (size_t)std::max(1, currentKey.numChannels);
+	const size_t sweepFrames = frames.size() / framesChannels;
+	readFrame = std::min(sweepFrames - 1, (size_t)(sweepFraction(currentKey, playheadX) * sweepFrames));
+	valid.store(true);
+	ofLogNotice("ScanCache") << "Cached sweep ready: " << sweepFrames << " frames x " << framesChannels
+	                         << " channels (" << sweepFrames / sampleRate << " s)";
+}
+
+float ScanCache::sweepFraction(const Key & key, float playheadX) {
+	if (key.canvasWidth <= 0.0f) return 0.0f;
+	const float x = ofClamp(playheadX, 0.0f, key.canvasWidth);
+	const float f = (key.playheadSpeed >= 0.0f) ? x / key.canvasWidth : (key.canvasWidth - x) / key.canvasWidth;
+	return ofClamp(f, 0.0f, 0.999999f);
+}
+
+void ScanCache::renderSweep(Key key, ofPixels pixels, int imgWidth, int imgHeight, ColorPlanes planes) {
+	const float speed = std::abs(key.playheadSpeed);
+	const size_t channels = (size_t)std::max(1, key.numChannels);
+	const double sweepSeconds = key.canvasWidth / speed;
+	const size_t sweepFrames = std::max<size_t>(1, (size_t)(sweepSeconds * sampleRate));
+	const size_t fadeFrames = std::min(sweepFrames, (size_t)(kCrossfadeSeconds * sampleRate));
+	const size_t totalFrames = sweepFrames + fadeFrames;
+	if (totalFrames * channels * sizeof(float) > kMaxCacheBytes) {
+		ofLogNotice("ScanCache") << "Sweep of " << sweepSeconds << " s x " << channels << " channels exceeds "
+		                         << kMaxCacheBytes / (1024 * 1024) << " MB; staying on live synthesis.";
+		renderOk = false;
+		renderDone = true;
+		return;
+	}
+	std::vector<float> out(totalFrames * channels, 0.0f);
+
+	ColumnSonifier synth;
+	synth.setup(sampleRate);
+	synth.setParams(key.volume, key.minFreq, key.maxFreq);
+	synth.setSpatial(key.layout, key.brightnessSpread);
+	synth.setColorPlanes(key.colorSound ? &planes : nullptr);
+
+	// Render in sonifier quanta so column changes land on the same boundaries as live playback.
+	ofSoundBuffer block;
+	block.allocate(ColumnSonifier::kQuantumFrames, channels);
+	const auto & blockData = block.getBuffer();
+	for (size_t pos = 0; pos < totalFrames; pos += ColumnSonifier::kQuantumFrames) {
+		if (cancel.load()) {
+			renderOk = false;
+			renderDone = true;
+			return;
+		}
+
+		// Same motion model as ofApp::updatePlayheadPosition(), sampled at audio time.
+		const double t = pos / (double)sampleRate;
+		const float travelled = (float)std::fmod(t * speed, (double)key.canvasWidth);
+		const float playheadX = (key.playheadSpeed > 0.0f) ? travelled : key.canvasWidth - travelled;
+		const int columnX = (int)((playheadX - key.offsetX) / std::max(1e-6f, key.scale));
+		synth.renderColumnToBuffer(pixels, imgWidth, imgHeight, columnX, block);
+
+		const size_t n = std::min((size_t)ColumnSonifier::kQuantumFrames, totalFrames - pos);
+		std::copy(blockData.begin(), blockData.begin() + n * channels, out.begin() + pos * channels);
+		progress = (float)pos / totalFrames;
+	}
+
+	// Fold the continuation past the wrap into the head (equal-power) so a straight loop is seamless.
+	for (size_t i = 0; i < fadeFrames; i++) {
+		const float g = (float)i / fadeFrames;
+		const float gIn = std::sin(g * HALF_PI);
+		const float gOut = std::cos(g * HALF_PI);
+		for (size_t c = 0; c < channels; c++) {
+			float & head = out[i * channels + c];
+			head = head * gIn + out[(sweepFrames + i) * channels + c] * gOut;
+		}
+	}
+	out.resize(sweepFrames * channels);
+
+	rendered.swap(out);
+	progress = 1.0f;
+	renderOk = true;
+	renderDone = true;
+}
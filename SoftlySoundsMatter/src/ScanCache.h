@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include "ColumnSonifier.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Pre-renders one full playhead sweep over a frozen image into memory, then plays it back in a loop.
+// The render runs on a background thread with its own ColumnSonifier; the loop seam is crossfaded
+// at render time so playback is a plain copy. While a render is in progress (or after any parameter
+// change) `render()` returns false and the caller falls back to live synthesis.
+class ScanCache {
+public:
+	// Everything that affects the rendered sweep. Any change invalidates the cache.
+	struct Key {
+		uint64_t imageGeneration = 0;
+		float playheadSpeed = 0.0f; // screen px/s (sign = direction)
+		float canvasWidth = 0.0f;   // screen px the playhead wraps at
+		float offsetX = 0.0f;       // screen -> image transform (see ofApp::getProcessedTransform)
+		float scale = 1.0f;
+		float volume = 0.0f;
+		float minFreq = 0.0f;
+		float maxFreq = 0.0f;
+		int numChannels = 2;        // output channels rendered into the cache (interleaved)
+		ColumnSonifier::SpeakerLayout layout = ColumnSonifier::SpeakerLayout::Line;
+		float brightnessSpread = 0.0f;
+		bool colorSound = false;    // render with the image's color planes
+
+		bool operator==(const Key & o) const {
+			return imageGeneration == o.imageGeneration && playheadSpeed == o.playheadSpeed &&
+			       canvasWidth == o.canvasWidth && offsetX == o.offsetX && scale == o.scale &&
+			       volume == o.volume && minFreq == o.minFreq && maxFreq == o.maxFreq &&
+			       numChannels == o.numChannels && layout == o.layout && brightnessSpread == o.brightnessSpread &&
+			       colorSound == o.colorSound;
+		}
+		bool operator!=(const Key & o) const { return !(*this == o); }
+	};
+
+	ScanCache() = default;
+	~ScanCache();
+
+	// Non-copyable (owns a worker thread)
+	ScanCache(const ScanCache &) = delete;
+	ScanCache & operator=(const ScanCache &) = delete;
+
+	/// Configure the sample rate used for rendering.
+	void setup(float sampleRate);
+	/// Cancel any render and release the cached sweep (safe to call multiple times).
+	void close();
+
+	/// Enable/disable the cache. Disabling invalidates the current render.
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return enabled; }
+
+	/// Main thread: start a new render once `key` has been stable for a moment, and publish finished renders.
+	/// `playheadX` (screen px) aligns the playback position with the visible playhead when a render is published.
+	/// `planes` (optional) is snapshotted with the pixels when `key.colorSound` is set.
+	void update(const Key & key, const ofPixels & pixels, int imgWidth, int imgHeight, const ColorPlanes * planes,
+	            float playheadX, uint64_t nowMs);
+
+	/// Audio thread: copy the next frames of the cached sweep into `out`.
+	/// @return false when no valid render is available or `out` has a different channel count
+	///         (caller should synthesize live).
+	bool render(ofSoundBuffer & out);
+
+	/// True when a finished render is being played back.
+	bool isReady() const { return valid.load(); }
+	/// True while the background thread is rendering.
+	bool isRendering() const { return worker.joinable() && !renderDone.load(); }
+	/// Render progress of the in-flight job (0..1).
+	float getProgress() const { return progress.load(); }
+
+private:
+	// Largest sweep we are willing to keep in memory (slow speeds / many channels need huge buffers).
+	static constexpr size_t kMaxCacheBytes = 64u * 1024u * 1024u;
+	// Loop seam crossfade length.
+	static constexpr float kCrossfadeSeconds = 0.05f;
+	// Wait this long after the last key change before starting a render (knob movement settles).
+	static constexpr uint64_t kSettleMs = 500;
+
+	float sampleRate = 44100.0f;
+	bool enabled = false;
+
+	Key currentKey;      // key of the published or in-flight render
+	Key pendingKey;      // last key seen by update()
+	uint64_t pendingSinceMs = 0;
+	bool hasJob = false; // a render for currentKey was started (and possibly published)
+
+	// Playback state (audio thread reads `frames` only while `valid` is set).
+	std::vector<float> frames; // interleaved, `framesChannels` per frame
+	size_t framesChannels = 1;
+	size_t readFrame = 0;
+	std::atomic<bool> valid { false };
+	std::atomic<bool> reading { false };
+
+	// Worker state
+	std::thread worker;
+	std::vector<float> rendered;
+	std::atomic<bool> cancel { false };
+	std::atomic<bool> renderDone { false };
+	std::atomic<bool> renderOk { false };
+	std::atomic<float> progress { 0.0f };
+
+	/// Stop playback from the cache and wait until the audio thread no longer reads `frames`.
+	void invalidate();
+	/// Cancel and join the worker thread, if any.
+	void stopWorker();
+	/// Worker entry point: render one sweep for `key` into `rendered`.
+	void renderSweep(Key key, ofPixels pixels, int imgWidth, int imgHeight, ColorPlanes planes);
+	/// Swap a finished render into playback, aligned to the current playhead.
+	void publish(float playheadX);
+	/// Fractional sweep position (0..1) for a screen-space playhead at `playheadX`.
+	static float sweepFraction(const Key & key, float playheadX);
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Lock-free single-producer / single-consumer ring buffer for trivially copyable items.
+// Storage is allocated by `reset()` (not real-time safe); `push()`/`pop()` only touch atomics and
+// memory, so one side can run on the audio thread.
+template <typename T>
+class SpscRing {
+public:
+	/// (Re)allocate storage for at least `minCapacity` items and clear the ring.
+	/// Must not run concurrently with `push()`/`pop()`.
+	void reset(size_t minCapacity) {
+		size_t cap = 1;
+		while (cap < minCapacity) cap <<= 1;
+		storage.assign(cap, T {});
+		mask = cap - 1;
+		head.store(0);
+		tail.store(0);
+	}
+
+	/// Total capacity in items.
+	size_t capacity() const { return storage.size(); }
+	/// Items currently queued (approximate when called from a third thread).
+	size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+	/// Producer: append all `n` items or nothing.
+	/// @return false when there is not enough free space (nothing is written).
+	bool push(const T * items, size_t n) {
+		const size_t h = head.load(std::memory_order_relaxed);
+		const size_t t = tail.load(std::memory_order_acquire);
+		if (storage.size() - (h - t) < n) return false;
+		const size_t first = std::min(n, storage.size() - (h & mask));
+		std::copy_n(items, first, storage.data() + (h & mask));
+		std::copy_n(items + first, n - first, storage.data());
+		head.store(h + n, std::memory_order_release);
+		return true;
+	}
+
+	/// Producer: append one item.
+	bool push(const T & item) { return push(&item, 1); }
+
+	/// Consumer: move up to `maxItems` items into `out`.
+	/// @return number of items popped.
+	size_t pop(T * out, size_t maxItems) {
+		const size_t t = tail.load(std::memory_order_relaxed);
+		const size_t h = head.load(std::memory_order_acquire);
+		const size_t n = std::min(maxItems, h - t);
+		const size_t first = std::min(n, storage.size() - (t & mask));
+		std::copy_n(storage.data() + (t & mask), first, out);
+		std::copy_n(storage.data(), n - first, out + first);
+		tail.store(t + n, std::memory_order_release);
+		return n;
+	}
+
+	/// Consumer: look at the oldest item without removing it. Returns false when empty.
+	bool peek(T & out) const {
+		const size_t t = tail.load(std::memory_order_relaxed);
+		if (head.load(std::memory_order_acquire) == t) return false;
+		out = storage[t & mask];
+		return true;
+	}
+
+private:
+	std::vector<T> storage;
+	size_t mask = 0;
+	// Monotonic counters; index = counter & mask.
+	std::atomic<size_t> head { 0 };
+	std::atomic<size_t> tail { 0 };
+};
@@ -0,0 +1,292 @@
+#include "WavetableSynth.h"
+
+#include "PitchMapping.h"
+
+#include <algorithm>
+#include <cmath>
+
+WavetableSynth::~WavetableSynth() {
+	close();
+}
+
+void WavetableSynth::setup(float sr) {
+	close();
+	sampleRate = sr;
+}
+
+void WavetableSynth::close() {
+	stopWorker();
+	active.store(nullptr);
+	while (reading.load()) std::this_thread::yield();
+	activeOwner.reset();
+	built.reset();
+	waveform.clear();
+}
+
+void WavetableSynth::setParams(float v, float minF, float maxF) {
+	volume = v;
+	minFreq = minF;
+	maxFreq = maxF;
+}
+
+void WavetableSynth::buildFromRegion(const ofPixels & pixels, int imgWidth, int imgHeight, const ofRectangle & region) {
+	if (!pixels.isAllocated() || imgWidth <= 0 || imgHeight <= 0) return;
+
+	const int x0 = ofClamp((int)region.getLeft(), 0, imgWidth - 1);
+	const int y0 = ofClamp((int)region.getTop(), 0, imgHeight - 1);
+	const int x1 = ofClamp((int)region.getRight(), x0 + 1, imgWidth);
+	const int y1 = ofClamp((int)region.getBottom(), y0 + 1, imgHeight);
+
+	// Snapshot the region so the worker never races with ImageProcessor.
+	ofPixels regionPixels;
+	regionPixels.allocate(x1 - x0, y1 - y0, OF_PIXELS_GRAY);
+	for (int y = y0; y < y1; y++) {
+		const unsigned char * src = &pixels[(size_t)y * imgWidth + x0];
+		std::copy(src, src + (x1 - x0), &regionPixels[(size_t)(y - y0) * (x1 - x0)]);
+	}
+
+	stopWorker();
+	cancel = false;
+	buildDone = false;
+	worker = std::thread(&WavetableSynth::buildTables, this, std::move(regionPixels));
+}
+
+void WavetableSynth::update() {
+	if (!worker.joinable() || !buildDone.load()) return;
+	worker.join();
+	if (!built) return;
+
+	// Swap in the new tables, then wait for an in-flight callback before releasing the old ones.
+	std::unique_ptr<Tables> retired = std::move(activeOwner);
+	activeOwner = std::move(built);
+	active.store(activeOwner.get());
+	while (reading.load()) std::this_thread::yield();
+	retired.reset();
+
+	const auto & level0 = activeOwner->levels[0];
+	waveform.assign(level0.begin(), level0.begin() + kTableSize);
+}
+
+void WavetableSynth::stopWorker() {
+	if (!worker.joinable()) return;
+	cancel = true;
+	worker.join();
+	cancel = false;
+	built.reset();
+}
+
+void WavetableSynth::buildTables(ofPixels regionPixels) {
+	std::vector<float> cycle;
+	auto tables = std::make_unique<Tables>();
+	if (traceWaveform(regionPixels, cycle) && buildMipmaps(cycle, *tables)) {
+		built = std::move(tables);
+	} else if (!cancel.load()) {
+		ofLogNotice("WavetableSynth") << "Wavetable region has no usable strokes; keeping the previous table.";
+	}
+	buildDone = true;
+}
+
+bool WavetableSynth::traceWaveform(const ofPixels & regionPixels, std::vector<float> & out) const {
+	const int w = regionPixels.getWidth();
+	const int h = regionPixels.getHeight();
+	if (w < 2 || h < 1) return false;
+
+	// Per column: brightness-weighted centroid row, top = +1, bottom = -1. NaN marks empty columns.
+	std::vector<float> columns((size_t)w, NAN);
+	int inked = 0;
+	for (int x = 0; x < w; x++) {
+		float sum = 0.0f;
+		float weighted = 0.0f;
+		for (int y = 0; y < h; y++) {
+			const float b = regionPixels[(size_t)y * w + x] / 255.0f;
+			if (b > brightnessThreshold) {
+				sum += b;
+				weighted += b * y;
+			}
+		}
+		if (sum > 0.0f) {
+			const float cy = weighted / sum;
+			columns[(size_t)x] = (h > 1) ? 1.0f - 2.0f * cy / (h - 1) : 0.0f;
+			inked++;
+		}
+	}
+	if (inked == 0) return false;
+
+	// Fill gaps by interpolating cyclically between the nearest inked columns.
+	std::vector<float> filled(columns);
+	for (int x = 0; x < w; x++) {
+		if (!std::isnan(columns[(size_t)x])) continue;
+		int l = x;
+		int r = x;
+		int dl = 0;
+		int dr = 0;
+		do { l = (l - 1 + w) % w; dl++; } while (std::isnan(columns[(size_t)l]));
+		do { r = (r + 1) % w; dr++; } while (std::isnan(columns[(size_t)r]));
+		const float t = (float)dl / (dl + dr);
+		filled[(size_t)x] = ofLerp(columns[(size_t)l], columns[(size_t)r], t);
+	}
+
+	// Resample to one cycle, remove DC, normalize.
+	out.assign(kTableSize, 0.0f);
+	for (int i = 0; i < kTableSize; i++) {
+		const float pos = (float)i * w / kTableSize;
+		const int a = (int)pos;
+		const int b = (a + 1) % w;
+		out[(size_t)i] = ofLerp(filled[(size_t)a], filled[(size_t)b], pos - a);
+	}
+	float mean = 0.0f;
+	for (float s : out) mean += s;
+	mean /= kTableSize;
+	float peak = 0.0f;
+	for (auto & s : out) {
+		s -= mean;
+		peak = std::max(peak, std::abs(s));
+	}
+	if (peak < 1e-6f) return false;
+	for (auto & s : out) s /= peak;
+	return true;
+}
+
+bool WavetableSynth::buildMipmaps(const std::vector<float> & cycle, Tables & tables) const {
+	const int n = kTableSize;
+	const int maxHarmonic = n / 2 - 1;
+
+	std::vector<float> cosTable((size_t)n);
+	std::vector<float> sinTable((size_t)n);
+	for (int i = 0; i < n; i++) {
+		cosTable[(size_t)i] = std::cos(TWO_PI * i / n);
+		sinTable[(size_t)i] = std::sin(TWO_PI * i / n);
+	}
+
+	// Forward DFT (harmonics 1..maxHarmonic; DC was removed when tracing).
+	std::vector<float> re((size_t)maxHarmonic + 1, 0.0f);
+	std::vector<float> im((size_t)maxHarmonic + 1, 0.0f);
+	for (int k = 1; k <= maxHarmonic; k++) {
+		if (cancel.load()) return false;
+		float r = 0.0f;
+		float s = 0.0f;
+		int idx = 0;
+		for (int i = 0; i < n; i++) {
+			r += cycle[(size_t)i] * cosTable[(size_t)idx];
+			s += cycle[(size_t)i] * sinTable[(size_t)idx];
+			idx += k;
+			if (idx >= n) idx -= n;
+		}
+		re[(size_t)k] = r * 2.0f / n;
+		im[(size_t)k] = s * 2.0f / n;
+	}
+
+	// Additive resynthesis per level; normalize every level by the full-band peak for even loudness.
+	float fullPeak = 0.0f;
+	for (int level = 0; level < kNumLevels; level++) {
+		const int harmonics = std::min(maxHarmonic, (n / 2) >> level);
+		auto & table = tables.levels[(size_t)level];
+		table.assign((size_t)n + 1, 0.0f);
+		for (int k = 1; k <= harmonics; k++) {
+			if (cancel.load()) return false;
+			const float a = re[(size_t)k];
+			const float b = im[(size_t)k];
+			if (a == 0.0f && b == 0.0f) continue;
+			int idx = 0;
+			for (int i = 0; i < n; i++) {
+				table[(size_t)i] += a * cosTable[(size_t)idx] + b * sinTable[(size_t)idx];
+				idx += k;
+				if (idx >= n) idx -= n;
+			}
+		}
+		if (level == 0) {
+			for (int i = 0; i < n; i++) fullPeak = std::max(fullPeak, std::abs(table[(size_t)i]));
+			if (fullPeak < 1e-6f) return false;
+		}
+		for (int i = 0; i < n; i++) table[(size_t)i] /= fullPeak;
+		table[(size_t)n] = table[0]; // guard sample
+	}
+	return true;
+}
+
+int WavetableSynth::selectLevel(float freq) const {
+	// Highest harmonic that stays below Nyquist at this pitch.
+	const float allowed = (sampleRate * 0.5f) / std::max(1.0f, freq);
+	int level = 0;
+	while (level < kNumLevels - 1 && (float)((kTableSize / 2) >> level) > allowed) level++;
+	return level;
+}
+
+int WavetableSynth::collectVoices(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX) {
+	int count = 0;
+	int y = 0;
+	while (y < imgHeight) {
+		float b = pixels[(size_t)y * imgWidth + columnX] / 255.0f;
+		if (b <= brightnessThreshold) {
+			y++;
+			continue;
+		}
+		// One stroke = one run of bright rows -> one voice at the weighted center.
+		float sum = 0.0f;
+		float weighted = 0.0f;
+		int len = 0;
+		while (y < imgHeight && b > brightnessThreshold) {
+			sum += b;
+			weighted += b * y;
+			len++;
+			if (++y < imgHeight) b = pixels[(size_t)y * imgWidth + columnX] / 255.0f;
+		}
+		Voice v;
+		v.row = ofClamp((int)std::lround(weighted / sum), 0, imgHeight - 1);
+		v.amplitude = sum / len;
+
+		if (count < kMaxVoices) {
+			voices[(size_t)count++] = v;
+		} else {
+			// Replace the weakest voice when this stroke is stronger.
+			auto weakest = std::min_element(voices.begin(), voices.end(),
+				[](const Voice & a, const Voice & b) { return a.amplitude < b.amplitude; });
+			if (weakest->amplitude < v.amplitude) *weakest = v;
+		}
+	}
+	return count;
+}
+
+void WavetableSynth::renderColumnToBuffer(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, ofSoundBuffer & out) {
+	auto & buf = out.getBuffer();
+	std::fill(buf.begin(), buf.end(), 0.0f);
+	if (imgWidth <= 0 || imgHeight <= 0 || !pixels.isAllocated()) return;
+
+	reading.store(true);
+	const Tables * tables = active.load();
+	if (!tables) {
+		reading.store(false);
+		return;
+	}
+
+	if ((int)phases.size() != imgHeight) phases.assign(imgHeight, 0.0f);
+	const int clampedX = ofClamp(columnX, 0, imgWidth - 1);
+	const int numVoices = collectVoices(pixels, imgWidth, imgHeight, clampedX);
+
+	const size_t frames = out.getNumFrames();
+	const size_t channels = out.getNumChannels();
+	const float norm = (numVoices > 0) ? volume / std::sqrt((float)numVoices) : 0.0f;
+	for (int v = 0; v < numVoices; v++) {
+		const Voice & voice = voices[(size_t)v];
+		const float freq = rowToFrequency(voice.row, imgHeight, minFreq, maxFreq);
+		const float inc = freq * kTableSize / sampleRate;
+		const float * table = tables->levels[(size_t)selectLevel(freq)].data();
+		const float amp = voice.amplitude * norm;
+		float phase = phases[(size_t)voice.row];
+		// Accumulate into channel 0; copied to the other channels below.
+		for (size_t i = 0; i < frames; i++) {
+			const int idx = (int)phase;
+			const float frac = phase - idx;
+			buf[i * channels] += (table[idx] + (table[idx + 1] - table[idx]) * frac) * amp;
+			phase += inc;
+			if (phase >= kTableSize) phase -= kTableSize;
+		}
+		phases[(size_t)voice.row] = phase;
+	}
+	reading.store(false);
+
+	for (size_t i = 0; i < frames; i++) {
+		float * frame = &buf[i * channels];
+		for (size_t c = 1; c < channels; c++) frame[c] = frame[0];
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "ofMain.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// "Wavetable zone" synthesis (after the original SketchSynth design).
+// A user-selected region of the processed image is traced into a single-cycle waveform
+// (per column: brightness-weighted centroid row -> sample value). A background thread builds
+// band-limited mipmap levels from it; the audio thread plays the current column's bright strokes
+// as a polyphonic table-lookup oscillator. Finished tables are swapped in atomically; the audio
+// callback never allocates or frees.
+class WavetableSynth {
+public:
+	/// Samples per single-cycle table.
+	static constexpr int kTableSize = 2048;
+	/// Mipmap levels; level L keeps harmonics up to (kTableSize / 2) >> L.
+	static constexpr int kNumLevels = 10;
+	/// Maximum simultaneous voices (strongest strokes in the column win).
+	static constexpr int kMaxVoices = 16;
+
+	WavetableSynth() = default;
+	~WavetableSynth();
+
+	// Non-copyable (owns a worker thread)
+	WavetableSynth(const WavetableSynth &) = delete;
+	WavetableSynth & operator=(const WavetableSynth &) = delete;
+
+	/// Configure the synthesis engine with the audio stream sample rate.
+	void setup(float sampleRate);
+	/// Cancel any build and release tables (safe to call multiple times).
+	void close();
+	/// Set runtime parameters controlling volume and frequency range mapping.
+	void setParams(float volume, float minFreq, float maxFreq);
+
+	/// Main thread: trace `region` (image pixel coordinates) of a grayscale image and rebuild the tables
+	/// on a background thread. Any in-flight build is cancelled.
+	void buildFromRegion(const ofPixels & pixels, int imgWidth, int imgHeight, const ofRectangle & region);
+	/// Main thread: publish finished builds and release retired tables.
+	void update();
+
+	/// True once a table set has been published.
+	bool hasTable() const { return activeOwner != nullptr; }
+	/// True while the background thread is building tables.
+	bool isBuilding() const { return worker.joinable(); }
+	/// Main-thread copy of the full-bandwidth waveform (for drawing); empty until a table is published.
+	const std::vector<float> & getWaveform() const { return waveform; }
+
+	/// Audio thread: render the bright strokes of `columnX` with the current wavetable into `out`
+	/// (same signal on every channel). Outputs silence when no table is available or inputs are invalid.
+	void renderColumnToBuffer(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX, ofSoundBuffer & out);
+
+private:
+	// One complete set of band-limited tables. Each level has a guard sample for interpolation.
+	struct Tables {
+		std::array<std::vector<float>, kNumLevels> levels;
+	};
+
+	struct Voice {
+		int row = 0;
+		float amplitude = 0.0f;
+	};
+
+	float sampleRate = 44100.0f;
+	float volume = 0.5f;
+	float minFreq = 100.0f;
+	float maxFreq = 4000.0f;
+	float brightnessThreshold = 0.1f;
+
+	// Published tables: the audio thread reads `active` while `reading` is set.
+	std::unique_ptr<Tables> activeOwner;
+	std::atomic<const Tables *> active { nullptr };
+	std::atomic<bool> reading { false };
+	std::vector<float> waveform;
+
+	// Builder state
+	std::thread worker;
+	std::unique_ptr<Tables> built;
+	std::atomic<bool> cancel { false };
+	std::atomic<bool> buildDone { false };
+
+	// Audio-thread state
+	std::vector<float> phases; // per image row, in table samples
+	std::array<Voice, kMaxVoices> voices {};
+
+	/// Cancel and join the builder thread, if any.
+	void stopWorker();
+	/// Worker entry point: trace `region` pixels into a waveform and build all mipmap levels.
+	void buildTables(ofPixels regionPixels);
+
+	/// Trace a grayscale region into one cycle of `kTableSize` samples. Returns false if the region has no ink.
+	bool traceWaveform(const ofPixels & regionPixels, std::vector<float> & out) const;
+	/// Build band-limited levels from a single-cycle waveform (DFT, then additive resynthesis per level).
+	bool buildMipmaps(const std::vector<float> & cycle, Tables & tables) const;
+	/// Pick the mipmap level whose highest harmonic stays below Nyquist at `freq`.
+	int selectLevel(float freq) const;
+	/// Collect up to `kMaxVoices` strokes (runs of bright rows) from a column. Returns the voice count.
+	int collectVoices(const ofPixels & pixels, int imgWidth, int imgHeight, int columnX);
+};
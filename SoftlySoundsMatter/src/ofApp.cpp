@@ -18,9 +18,14 @@
 static constexpr const char *kGpioChipPath = "/dev/gpiochip0";
 static constexpr int kBtn1Gpio = 17;
 static constexpr int kBtn2Gpio = 27;
+static constexpr int kBtn3Gpio = 22;
 static constexpr bool kBtnActiveLow = true;
 static constexpr bool kBtnPullUp = true;
 
+// Keystone calibration file (in data/) and arrow-key step (normalized camera coordinates).
+static constexpr const char *kKeystoneFile = "keystone.json";
+static constexpr float kKeystoneStep = 0.005f;
+
 ofApp::ofApp() {
 	// Ensure runtime params start at the configured defaults (even before the first knob read).
 	resetAllParametersToDefaults();
@@ -28,6 +33,8 @@ ofApp::ofApp() {
 
 ofApp::~ofApp() {
 	audio.close();
+	scanCache.close();
+	wavetable.close();
 	video.close();
 }
 
@@ -50,16 +57,41 @@ void ofApp::setup() {
 
 	video.setup();
 	image.setScaleFactor(0.25f);
-	sonifier.setup(sampleRate, bufferSize);
+	// Processed maps survive restarts: re-opening a sketch (or recalling a preset) maps the stored result.
+	image.enableFeatureCache(ofToDataPath("cache/features", true));
+	if (Keystone::loadCorners(ofToDataPath(kKeystoneFile), keystoneCorners)) {
+		ofLogNotice("ofApp") << "Loaded keystone calibration";
+	}
+	image.setKeystone(keystoneCorners);
+	sonifier.setup(sampleRate);
+	scanCache.setup(sampleRate);
+	wavetable.setup(sampleRate);
+	granular.setup(sampleRate);
 
 	// Audio callback is owned by AudioEngine for consistency with Video/Image classes.
 	// We provide a render function that uses current app state.
+	// The channel count is negotiated from the output device (up to the sonifier's spatial limit).
+	audio.setMaxOutputChannels(ColumnSonifier::kMaxChannels);
 	audio.setup(sampleRate, bufferSize, [&](ofSoundBuffer & buffer) {
 		if (video.isCapturing() || !image.hasProcessed()) {
 			buffer.getBuffer().assign(buffer.getNumFrames() * buffer.getNumChannels(), 0.0f);
 			return;
 		}
+		if (synthMode == SynthMode::Wavetable) {
+			wavetable.setParams(params.volume, params.minFreq, params.maxFreq);
+			wavetable.renderColumnToBuffer(image.getSobelPixels(), image.getWidth(), image.getHeight(), getImageXFromPlayhead(), buffer);
+			return;
+		}
+		if (synthMode == SynthMode::Granular) {
+			granular.setParams(params.volume, params.minFreq, params.maxFreq);
+			granular.renderColumnToBuffer(image.getSobelPixels(), image.getWidth(), image.getHeight(), getImageXFromPlayhead(), buffer);
+			return;
+		}
+		// Pre-rendered sweep when available; live synthesis otherwise.
+		if (scanCache.render(buffer)) return;
 		sonifier.setParams(params.volume, params.minFreq, params.maxFreq);
+		sonifier.setSpatial(params.speakerLayout, params.brightnessSpread);
+		sonifier.setColorPlanes(params.colorSound ? &image.getColorPlanes() : nullptr);
 		const int imgX = getImageXFromPlayhead();
 		sonifier.renderColumnToBuffer(image.getSobelPixels(), image.getWidth(), image.getHeight(), imgX, buffer);
 	});
@@ -73,6 +105,7 @@ void ofApp::setup() {
 	// Direct GPIO buttons (hardcoded pins).
 	(void)btn1.setup(kGpioChipPath, kBtn1Gpio, kBtnActiveLow, kBtnPullUp);
 	(void)btn2.setup(kGpioChipPath, kBtn2Gpio, kBtnActiveLow, kBtnPullUp);
+	(void)btn3.setup(kGpioChipPath, kBtn3Gpio, kBtnActiveLow, kBtnPullUp);
 }
 
 void ofApp::update() {
@@ -83,6 +116,7 @@ void ofApp::update() {
 	for (auto & k : knobs) k.update(nowMs);
 	btn1.update(nowMs);
 	btn2.update(nowMs);
+	btn3.update(nowMs);
 
 	// Optional: one-line terminal debug output for raw knob values.
 	// Enable by compiling with -DSSM_DEBUG_KNOBS=1.
@@ -130,6 +164,7 @@ void ofApp::update() {
 	// Button mappings (edge-triggered):
 	// - BTN1 pressed: same as Space (toggle preview/playback)
 	// - BTN2 pressed: reset all params (same as 'R')
+	// - BTN3 pressed: start/stop recording the output (same as 'X')
 	if (btn1.consumePressed()) {
 		if (video.isCapturing()) {
 			ofPixels rgb;
@@ -144,6 +179,9 @@ void ofApp::update() {
 	if (btn2.consumePressed()) {
 		resetAllParametersToDefaults();
 	}
+	if (btn3.consumePressed()) {
+		toggleRecording();
+	}
 
 	// Update processing params and process if dirty
 	image.setParams(params.contrast, params.exposure, params.sobelStrength);
@@ -152,7 +190,13 @@ void ofApp::update() {
 	// Update playhead only when scanning a processed image (not while live capture)
 	if (image.hasProcessed() && !video.isCapturing()) {
 		updatePlayheadPosition();
+		if (synthMode == SynthMode::Wavetable) {
+			updateWavetable();
+		} else if (synthMode == SynthMode::Columns) {
+			updateScanCache(nowMs);
+		}
 	}
+	wavetable.update();
 }
 
 void ofApp::updatePlayheadPosition() {
@@ -165,6 +209,45 @@ void ofApp::updatePlayheadPosition() {
 	}
 }
 
+void ofApp::updateScanCache(uint64_t nowMs) {
+	const auto t = getProcessedTransform();
+	ScanCache::Key key;
+	key.imageGeneration = image.getGeneration();
+	key.playheadSpeed = params.playheadSpeed;
+	key.canvasWidth = std::max(1.0f, (float)ofGetWidth());
+	key.offsetX = t.offsetX;
+	key.scale = t.scale;
+	key.volume = params.volume;
+	key.minFreq = params.minFreq;
+	key.maxFreq = params.maxFreq;
+	key.numChannels = audio.getNumOutputChannels();
+	key.layout = params.speakerLayout;
+	key.brightnessSpread = params.brightnessSpread;
+	key.colorSound = params.colorSound;
+	scanCache.update(key, image.getSobelPixels(), image.getWidth(), image.getHeight(), &image.getColorPlanes(), playheadX, nowMs);
+}
+
+void ofApp::updateWavetable() {
+	// Rebuild when the zone moved or the processed image changed (new frame or new params).
+	if (!wavetableDirty && wavetableGeneration == image.getGeneration()) return;
+	wavetableDirty = false;
+	wavetableGeneration = image.getGeneration();
+	wavetable.buildFromRegion(image.getSobelPixels(), image.getWidth(), image.getHeight(), getWavetableRegion());
+}
+
+ofRectangle ofApp::getWavetableRegion() const {
+	if (!wavetableRegion.isEmpty()) return wavetableRegion;
+	// Default zone: the left quarter of the image, full height.
+	return ofRectangle(0, 0, std::max(2, image.getWidth() / 4), image.getHeight());
+}
+
+glm::vec2 ofApp::screenToImage(float x, float y) const {
+	const auto t = getProcessedTransform();
+	const float s = std::max(1e-6f, t.scale);
+	return glm::vec2(ofClamp((x - t.offsetX) / s, 0.0f, (float)image.getWidth()),
+	                 ofClamp((y - t.offsetY) / s, 0.0f, (float)image.getHeight()));
+}
+
 ofApp::DrawTransform ofApp::getProcessedTransform() const {
 	DrawTransform t;
 	if (!image.hasProcessed()) return t;
@@ -180,6 +263,20 @@ ofApp::DrawTransform ofApp::getProcessedTransform() const {
 	return t;
 }
 
+ofApp::DrawTransform ofApp::getVideoTransform() const {
+	DrawTransform t;
+	const float windowW = std::max(1.0f, (float)ofGetWidth());
+	const float windowH = std::max(1.0f, (float)ofGetHeight());
+
+	const float vw = std::max(1.0f, (float)video.grabber().getWidth());
+	const float vh = std::max(1.0f, (float)video.grabber().getHeight());
+	// Cover the window (fill + crop) to avoid letterboxing gaps.
+	t.scale = std::max(windowW / vw, windowH / vh);
+	t.offsetX = (windowW - vw * t.scale) * 0.5f;
+	t.offsetY = (windowH - vh * t.scale) * 0.5f;
+	return t;
+}
+
 int ofApp::getImageXFromPlayhead() const {
 	if (!image.hasProcessed()) return 0;
 	const auto t = getProcessedTransform();
@@ -192,29 +289,24 @@ void ofApp::draw() {
 		drawVideoPreview();
 	} else if (image.hasProcessed()) {
 		drawProcessedView();
+		if (synthMode == SynthMode::Wavetable) drawWavetableZone();
 		drawStatusOverlay();
 	}
 }
 
 void ofApp::drawVideoPreview() {
 	if (video.isGrabberPipelineUp()) {
-		const float windowW = std::max(1.0f, (float)ofGetWidth());
-		const float windowH = std::max(1.0f, (float)ofGetHeight());
-
-		const float vw = std::max(1.0f, (float)video.grabber().getWidth());
-		const float vh = std::max(1.0f, (float)video.grabber().getHeight());
-		// Cover the window (fill + crop) to avoid letterboxing gaps.
-		const float videoScale = std::max(windowW / vw, windowH / vh);
-		const float offsetX = (windowW - vw * videoScale) * 0.5f;
-		const float offsetY = (windowH - vh * videoScale) * 0.5f;
+		const auto t = getVideoTransform();
 
 		ofPushMatrix();
-		ofTranslate(offsetX, offsetY);
-		ofScale(videoScale, videoScale);
+		ofTranslate(t.offsetX, t.offsetY);
+		ofScale(t.scale, t.scale);
 		ofSetColor(255);
 		video.grabber().draw(0, 0);
 		ofPopMatrix();
 
+		if (calibratingKeystone) drawKeystoneCalibration();
+
 		ofSetColor(0, 255, 0);
 		return;
 	}
@@ -251,6 +343,56 @@ void ofApp::drawProcessedView() {
 	}
 }
 
+void ofApp::drawWavetableZone() {
+	const auto t = getProcessedTransform();
+	const ofRectangle r = getWavetableRegion();
+	const float x = t.offsetX + r.x * t.scale;
+	const float y = t.offsetY + r.y * t.scale;
+	const float w = r.width * t.scale;
+	const float h = r.height * t.scale;
+
+	// Red zone outline (as in the original SketchSynth) + the traced single-cycle waveform.
+	ofNoFill();
+	ofSetColor(255, 0, 0);
+	ofDrawRectangle(x, y, w, h);
+	ofFill();
+
+	const auto & wave = wavetable.getWaveform();
+	if (wave.empty()) return;
+	ofSetColor(255, 120, 120);
+	const int segments = 256;
+	const float midY = y + h * 0.5f;
+	for (int i = 0; i < segments; i++) {
+		const size_t a = (size_t)i * wave.size() / segments;
+		const size_t b = (size_t)(i + 1) * wave.size() / segments % wave.size();
+		ofDrawLine(x + w * i / segments, midY - wave[a] * h * 0.5f,
+		           x + w * (i + 1) / segments, midY - wave[b] * h * 0.5f);
+	}
+}
+
+void ofApp::drawKeystoneCalibration() {
+	const auto t = getVideoTransform();
+	const float vw = (float)video.grabber().getWidth();
+	const float vh = (float)video.grabber().getHeight();
+	auto toScreen = [&](const glm::vec2 & p) {
+		return glm::vec2(t.offsetX + p.x * vw * t.scale, t.offsetY + p.y * vh * t.scale);
+	};
+
+	ofSetColor(255, 200, 0);
+	for (int i = 0; i < 4; i++) {
+		const glm::vec2 a = toScreen(keystoneCorners[(size_t)i]);
+		const glm::vec2 b = toScreen(keystoneCorners[(size_t)((i + 1) % 4)]);
+		ofDrawLine(a.x, a.y, b.x, b.y);
+	}
+	for (int i = 0; i < 4; i++) {
+		const glm::vec2 p = toScreen(keystoneCorners[(size_t)i]);
+		ofSetColor(i == keystoneCorner ? ofColor(255, 0, 0) : ofColor(255, 200, 0));
+		ofDrawCircle(p.x, p.y, i == keystoneCorner ? 10 : 6);
+	}
+	ofSetColor(255);
+	ofDrawBitmapStringHighlight("keystone: 1-4 select corner, arrows/click move, 0 reset, K save", 12, 24);
+}
+
 void ofApp::drawStatusOverlay() {
 	// Bottom-right parameter HUD (always visible).
 	std::ostringstream ss;
@@ -261,7 +403,31 @@ void ofApp::drawStatusOverlay() {
 	ss << std::setprecision(0) << "speed:    " << params.playheadSpeed << "\n";
 	ss << std::setprecision(2) << "volume:   " << params.volume << "\n";
 	ss << std::setprecision(0) << "maxFreq:  " << params.maxFreq << "\n";
-	ss << "mode:     " << (video.isCapturing() ? "preview" : "playback");
+	ss << "mode:     " << (video.isCapturing() ? "preview" : "playback") << (image.isLoading() ? " (loading)" : "") << "\n";
+	ss << "synth:    ";
+	switch (synthMode) {
+	case SynthMode::Columns: ss << "columns"; break;
+	case SynthMode::Wavetable: ss << "wavetable"; break;
+	case SynthMode::Granular: ss << "granular (" << granular.getActiveGrainCount() << " grains)"; break;
+	}
+	ss << "\n";
+	ss << "output:   " << audio.getNumOutputChannels() << "ch "
+	   << (params.speakerLayout == ColumnSonifier::SpeakerLayout::Ring ? "ring" : "line")
+	   << (params.brightnessSpread > 0.0f ? " +spread" : "") << (params.colorSound ? " +color" : "") << "\n";
+	ss << "cache:    ";
+	if (!scanCache.isEnabled()) ss << "off";
+	else if (scanCache.isReady()) ss << "ready";
+	else if (scanCache.isRendering()) ss << "rendering " << (int)(scanCache.getProgress() * 100.0f) << "%";
+	else ss << "live";
+	ss << "\n";
+	ss << "record:   ";
+	if (audio.isRecording()) {
+		const auto & rec = audio.getRecorder();
+		ss << std::setprecision(1) << "on " << rec.getFramesWritten() / sampleRate << "s";
+		if (rec.getFramesDropped() > 0) ss << " (" << rec.getFramesDropped() << " dropped)";
+	} else {
+		ss << "off";
+	}
 
 	const std::string text = ss.str();
 	const int pad = 12;
@@ -275,6 +441,25 @@ void ofApp::drawStatusOverlay() {
 }
 
 void ofApp::keyPressed(int key) {
+	if (calibratingKeystone) {
+		switch (key) {
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+			keystoneCorner = key - '1';
+			return;
+		case '0':
+			keystoneCorners = Keystone::identityCorners();
+			image.setKeystone(keystoneCorners);
+			return;
+		case OF_KEY_LEFT: moveKeystoneCorner({ -kKeystoneStep, 0.0f }); return;
+		case OF_KEY_RIGHT: moveKeystoneCorner({ kKeystoneStep, 0.0f }); return;
+		case OF_KEY_UP: moveKeystoneCorner({ 0.0f, -kKeystoneStep }); return;
+		case OF_KEY_DOWN: moveKeystoneCorner({ 0.0f, kKeystoneStep }); return;
+		}
+	}
+
 	switch (key) {
 	case ' ':
 		// Toggle capture vs scanning a frozen frame
@@ -296,9 +481,88 @@ void ofApp::keyPressed(int key) {
 	case 'P':
 		togglePlayback();
 		break;
+	case 'c':
+	case 'C':
+		scanCache.setEnabled(!scanCache.isEnabled());
+		break;
+	case 'w':
+	case 'W':
+		synthMode = (synthMode == SynthMode::Wavetable) ? SynthMode::Columns : SynthMode::Wavetable;
+		break;
+	case 'g':
+	case 'G':
+		synthMode = (synthMode == SynthMode::Granular) ? SynthMode::Columns : SynthMode::Granular;
+		break;
+	case 's':
+	case 'S':
+		// Speaker layout: line (L..R) vs ring (around the room)
+		params.speakerLayout = (params.speakerLayout == ColumnSonifier::SpeakerLayout::Line)
+			? ColumnSonifier::SpeakerLayout::Ring
+			: ColumnSonifier::SpeakerLayout::Line;
+		break;
+	case 'd':
+	case 'D':
+		// Brightness-dependent diffusion: dim voices spread over all speakers
+		params.brightnessSpread = (params.brightnessSpread > 0.0f) ? 0.0f : 1.0f;
+		break;
+	case 'h':
+	case 'H':
+		// Color-aware sonification: keep hue/saturation planes next to the Sobel map
+		params.colorSound = !params.colorSound;
+		image.setColorPlanesEnabled(params.colorSound);
+		break;
+	case 'x':
+	case 'X':
+		toggleRecording();
+		break;
+	case 'o':
+	case 'O':
+		openNextDataImage();
+		break;
+	case 'k':
+	case 'K':
+		toggleKeystoneCalibration();
+		break;
+	}
+}
+
+void ofApp::mousePressed(int x, int y, int button) {
+	// Keystone calibration: click places the selected corner.
+	if (calibratingKeystone && video.isCapturing()) {
+		const auto t = getVideoTransform();
+		const float vw = std::max(1.0f, (float)video.grabber().getWidth());
+		const float vh = std::max(1.0f, (float)video.grabber().getHeight());
+		const glm::vec2 p((x - t.offsetX) / (vw * t.scale), (y - t.offsetY) / (vh * t.scale));
+		moveKeystoneCorner(p - keystoneCorners[(size_t)keystoneCorner]);
+		return;
+	}
+	// Drag to select the wavetable zone (wavetable mode, playback only).
+	if (synthMode != SynthMode::Wavetable || video.isCapturing() || !image.hasProcessed()) return;
+	selectingRegion = true;
+	selectionStart = screenToImage((float)x, (float)y);
+}
+
+void ofApp::mouseDragged(int x, int y, int button) {
+	if (!selectingRegion) return;
+	const glm::vec2 p = screenToImage((float)x, (float)y);
+	ofRectangle r(std::min(selectionStart.x, p.x), std::min(selectionStart.y, p.y),
+	              std::abs(p.x - selectionStart.x), std::abs(p.y - selectionStart.y));
+	if (r.width >= 2.0f && r.height >= 2.0f) {
+		wavetableRegion = r;
 	}
 }
 
+void ofApp::mouseReleased(int x, int y, int button) {
+	if (!selectingRegion) return;
+	mouseDragged(x, y, button);
+	selectingRegion = false;
+	wavetableDirty = true;
+}
+
+void ofApp::dragEvent(ofDragInfo dragInfo) {
+	if (!dragInfo.files.empty()) loadImageFile(dragInfo.files.front());
+}
+
 void ofApp::resetImageParameters() {
 	params.contrast = 1.0f;
 	params.exposure = 0.0f;
@@ -334,4 +598,58 @@ void ofApp::togglePlayback() {
 	}
 }
 
+void ofApp::toggleRecording() {
+	if (audio.isRecording()) {
+		audio.stopRecording();
+		return;
+	}
+	// data/recordings/ssm-YYYYmmdd-HHMMSS.wav
+	ofDirectory::createDirectory("recordings", true, true);
+	const std::string path = ofToDataPath("recordings/ssm-" + ofGetTimestampString("%Y%m%d-%H%M%S") + ".wav", true);
+	(void)audio.startRecording(path);
+}
+
+void ofApp::loadImageFile(const std::string & path) {
+	// Decoded off the main thread at the processing scale; the source swaps in during image.update().
+	image.loadFromFileAsync(path, [this](bool ok, const std::string & loadedPath) {
+		if (!ok) return;
+		ofLogNotice("ofApp") << "Loaded " << loadedPath;
+		// Scan the file instead of the camera (same as leaving preview with Space).
+		if (video.isCapturing()) video.pause();
+	});
+}
 
+void ofApp::openNextDataImage() {
+	ofDirectory dir(ofToDataPath("", true));
+	dir.allowExt("jpg");
+	dir.allowExt("jpeg");
+	dir.allowExt("png");
+	dir.listDir();
+	if (dir.size() == 0) {
+		ofLogNotice("ofApp") << "No images in " << dir.getAbsolutePath();
+		return;
+	}
+	dir.sort();
+	nextDataImage %= dir.size();
+	loadImageFile(dir.getPath(nextDataImage++));
+}
+
+void ofApp::toggleKeystoneCalibration() {
+	calibratingKeystone = !calibratingKeystone;
+	if (calibratingKeystone) {
+		// Calibrate against the live camera.
+		if (!video.isCapturing()) video.resume();
+		return;
+	}
+	image.setKeystone(keystoneCorners);
+	if (Keystone::saveCorners(ofToDataPath(kKeystoneFile), keystoneCorners)) {
+		ofLogNotice("ofApp") << "Saved keystone calibration";
+	}
+}
+
+void ofApp::moveKeystoneCorner(const glm::vec2 & delta) {
+	glm::vec2 & p = keystoneCorners[(size_t)keystoneCorner];
+	p.x = ofClamp(p.x + delta.x, 0.0f, 1.0f);
+	p.y = ofClamp(p.y + delta.y, 0.0f, 1.0f);
+	image.setKeystone(keystoneCorners);
+}
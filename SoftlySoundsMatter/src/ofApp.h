@@ -3,8 +3,11 @@
 
 #include "AudioEngine.h"
 #include "ColumnSonifier.h"
+#include "GranularSynth.h"
 #include "ImageProcessor.h"
+#include "ScanCache.h"
 #include "VideoCaptureManager.h"
+#include "WavetableSynth.h"
 #include "AnalogKnob.h"
 #include "Mcp3008Spi.h"
 #include "GpioButton.h"
@@ -21,6 +24,10 @@ public:
 	void update();
 	void draw();
 	void keyPressed(int key);
+	void mousePressed(int x, int y, int button);
+	void mouseDragged(int x, int y, int button);
+	void mouseReleased(int x, int y, int button);
+	void dragEvent(ofDragInfo dragInfo);
 
 private:
 	// Former GUI-controlled parameters (now headless / no on-screen widgets).
@@ -33,6 +40,20 @@ private:
 		float volume = 0.5f;
 		float minFreq = 100.0f;
 		float maxFreq = 4000.0f;
+
+		// Spatial output (keyboard-controlled)
+		ColumnSonifier::SpeakerLayout speakerLayout = ColumnSonifier::SpeakerLayout::Line;
+		float brightnessSpread = 0.0f;
+
+		// Color-aware sonification (hue -> octave, saturation -> timbre)
+		bool colorSound = false;
+	};
+
+	// Which synthesis engine renders the playhead column.
+	enum class SynthMode {
+		Columns,   // ColumnSonifier sine bank (optionally via ScanCache)
+		Wavetable, // WavetableSynth playing the traced "wavetable zone"
+		Granular   // GranularSynth grains emitted around the playhead
 	};
 
 	struct DrawTransform {
@@ -42,26 +63,41 @@ private:
 	};
 
 	DrawTransform getProcessedTransform() const;
+	DrawTransform getVideoTransform() const;
 
 	void updatePlayheadPosition();
+	void updateScanCache(uint64_t nowMs);
+	void updateWavetable();
+	ofRectangle getWavetableRegion() const;
+	glm::vec2 screenToImage(float x, float y) const;
 	int getImageXFromPlayhead() const;
 
 	void drawVideoPreview();
 	void drawProcessedView();
 	void drawStatusOverlay();
+	void drawWavetableZone();
+	void drawKeystoneCalibration();
 
 	void resetImageParameters();
 	void resetAllParametersToDefaults();
 	void togglePlayback();
+	void toggleRecording();
+	void loadImageFile(const std::string & path);
+	void openNextDataImage();
+	void toggleKeystoneCalibration();
+	void moveKeystoneCorner(const glm::vec2 & delta);
 
 	// Subsystems
 	AudioEngine audio;
 	VideoCaptureManager video;
 	ImageProcessor image;
 	ColumnSonifier sonifier;
+	ScanCache scanCache;
+	WavetableSynth wavetable;
+	GranularSynth granular;
 
 	float sampleRate = 44100;
-	int bufferSize = 512;
+	int bufferSize = 512; // device period; ColumnSonifier renders in fixed quanta, so any size works
 
 	Params params;
 	float lastPlayheadSpeed = 120.0f;
@@ -69,6 +105,24 @@ private:
 	// Playhead
 	float playheadX = 0.0f;
 
+	SynthMode synthMode = SynthMode::Columns;
+
+	// Wavetable zone in image pixel coordinates (empty = default zone), selected by mouse drag.
+	ofRectangle wavetableRegion;
+	bool wavetableDirty = true;
+	uint64_t wavetableGeneration = 0;
+	bool selectingRegion = false;
+	glm::vec2 selectionStart;
+
+	// Keystone calibration (camera preview): four paper corners in normalized camera coordinates,
+	// persisted to data/keystone.json.
+	Keystone::Corners keystoneCorners = Keystone::identityCorners();
+	bool calibratingKeystone = false;
+	int keystoneCorner = 0; // TL, TR, BR, BL
+
+	// Index of the next data/ image opened with 'O'.
+	size_t nextDataImage = 0;
+
 	// Drawing
 	float drawScale = 1.0f;
 
@@ -89,7 +143,8 @@ private:
 	std::array<int, 6> knobLatchRaw = {0, 0, 0, 0, 0, 0};
 	std::array<bool, 6> knobUnlatched = {true, true, true, true, true, true};
 
-	// Two direct GPIO buttons (Pi header) - configured at runtime via env vars.
+	// Direct GPIO buttons (Pi header).
 	GpioButton btn1;
 	GpioButton btn2;
+	GpioButton btn3;
 };